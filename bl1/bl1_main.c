@@ -35,6 +35,7 @@
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <timestamp.h>
 #include "bl1_private.h"
 
 /*******************************************************************************
@@ -106,6 +107,8 @@ void bl1_init_bl2_mem_layout(const meminfo_t *bl1_mem_layout,
   ******************************************************************************/
 void bl1_main(void)
 {
+	TS_RECORD(TS_MAIN_ENTRY);
+
 	/* Announce our arrival */
 	NOTICE(FIRMWARE_WELCOME_STR);
 	NOTICE("BL1: %s\n", version_string);
@@ -135,6 +138,8 @@ void bl1_main(void)
 	/* Perform platform setup in BL1. */
 	bl1_platform_setup();
 
+	TS_RECORD(TS_PLATFORM_SETUP_DONE);
+
 	SET_PARAM_HEAD(&bl2_image_info, PARAM_IMAGE_BINARY, VERSION_1, 0);
 	SET_PARAM_HEAD(&bl2_ep, PARAM_EP, VERSION_1, 0);
 
@@ -174,6 +179,16 @@ void bl1_main(void)
 	VERBOSE("BL1: BL2 memory layout address = 0x%llx\n",
 		(unsigned long long) bl2_tzram_layout);
 
+#if BOOT_TIMESTAMPS
+	/*
+	 * Hand the probes recorded so far to BL2. BL1's RW memory is not
+	 * reclaimed by BL2 so the table can be passed in place.
+	 */
+	TS_RECORD(TS_EXIT);
+	flush_dcache_range((unsigned long)&ts_table, sizeof(ts_table));
+	bl2_ep.args.arg2 = (unsigned long)&ts_table;
+#endif
+
 	bl1_run_bl2(&bl2_ep);
 
 	return;
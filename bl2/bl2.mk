@@ -35,3 +35,13 @@ BL2_SOURCES		+=	bl2/bl2_main.c				\
 				lib/locks/exclusive/spinlock.S
 
 BL2_LINKERFILE		:=	bl2/bl2.ld.S
+
+# Share large image copies between the primary and helper CPUs
+BL2_PARALLEL_LOAD	:=	0
+
+$(eval $(call assert_boolean,BL2_PARALLEL_LOAD))
+$(eval $(call add_define,BL2_PARALLEL_LOAD))
+
+ifeq (${BL2_PARALLEL_LOAD},1)
+BL2_SOURCES		+=	bl2/bl2_parallel_load.c
+endif
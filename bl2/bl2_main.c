@@ -35,6 +35,7 @@
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <timestamp.h>
 #include "bl2_private.h"
 
 /*******************************************************************************
@@ -193,6 +194,8 @@ void bl2_main(void)
 	entry_point_info_t *bl31_ep_info;
 	int e;
 
+	TS_RECORD(TS_MAIN_ENTRY);
+
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
 
@@ -202,6 +205,13 @@ void bl2_main(void)
 	/* Perform platform setup in BL2 */
 	bl2_platform_setup();
 
+	TS_RECORD(TS_PLATFORM_SETUP_DONE);
+
+#if BL2_PARALLEL_LOAD
+	/* Bring up the helper CPUs that share the image copies */
+	bl2_parallel_load_init();
+#endif
+
 	/*
 	 * Load the subsequent bootloader images
 	 */
@@ -234,6 +244,17 @@ void bl2_main(void)
 		panic();
 	}
 
+#if BL2_PARALLEL_LOAD
+	/* All copies are complete, release the helper CPUs */
+	bl2_parallel_load_exit();
+#endif
+
+#if BOOT_TIMESTAMPS
+	/* Hand the probes recorded so far to BL3-1 */
+	TS_RECORD(TS_EXIT);
+	ts_export(bl2_to_bl31_params->timestamps);
+#endif
+
 	/* Flush the params to be passed to memory */
 	bl2_plat_flush_bl31_params();
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <cassert.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <string.h>
+#include "bl2_private.h"
+
+/*
+ * Images are split into chunks of this size, which are handed out to the
+ * primary and helper CPUs on a first come first served basis. The chunks end
+ * on boundaries of this size in the destination, so that no cache line is
+ * written and flushed by two CPUs.
+ */
+#define LOAD_CHUNK_SIZE		(64 * 1024)
+
+CASSERT((LOAD_CHUNK_SIZE % CACHE_WRITEBACK_GRANULE) == 0,
+	assert_load_chunk_size_not_cache_aligned);
+
+/*******************************************************************************
+ * State of the image copy currently being shared between CPUs. All fields
+ * other than 'lock' are protected by 'lock'. 'next' is the offset of the next
+ * chunk to hand out and 'completed' is the number of bytes that have been
+ * copied and flushed.
+ ******************************************************************************/
+typedef struct load_job {
+	spinlock_t lock;
+	uintptr_t dst;
+	uintptr_t src;
+	size_t size;
+	size_t next;
+	size_t completed;
+	unsigned int helpers;
+	unsigned int shutdown;
+} load_job_t;
+
+static load_job_t load_job;
+
+/*******************************************************************************
+ * Claim chunks of the current job and process them until none are left.
+ ******************************************************************************/
+static void process_chunks(void)
+{
+	uintptr_t dst, src;
+	size_t offset, length;
+
+	for (;;) {
+		spin_lock(&load_job.lock);
+		if (load_job.next >= load_job.size) {
+			spin_unlock(&load_job.lock);
+			return;
+		}
+
+		/* Stop at the next chunk boundary in the destination */
+		offset = load_job.next;
+		length = LOAD_CHUNK_SIZE -
+			((load_job.dst + offset) & (LOAD_CHUNK_SIZE - 1));
+		if (length > load_job.size - offset)
+			length = load_job.size - offset;
+		load_job.next += length;
+		dst = load_job.dst + offset;
+		src = load_job.src + offset;
+		spin_unlock(&load_job.lock);
+
+		memcpy((void *)dst, (const void *)src, length);
+		flush_dcache_range(dst, length);
+
+		spin_lock(&load_job.lock);
+		load_job.completed += length;
+		spin_unlock(&load_job.lock);
+	}
+}
+
+/*******************************************************************************
+ * Main loop of a helper CPU. The platform calls this on each helper it starts
+ * in bl2_plat_start_load_helpers(), with the MMU and data cache enabled using
+ * the same translation tables as the primary CPU. The function returns once
+ * the primary CPU calls bl2_parallel_load_exit().
+ ******************************************************************************/
+void bl2_load_helper_main(void)
+{
+	unsigned int shutdown;
+
+	for (;;) {
+		process_chunks();
+
+		/*
+		 * Wait for the primary CPU to publish more work. A SEV issued
+		 * after the check above sets the event register, so the
+		 * wakeup cannot be lost.
+		 */
+		wfe();
+
+		spin_lock(&load_job.lock);
+		shutdown = load_job.shutdown;
+		if (shutdown)
+			load_job.helpers--;
+		spin_unlock(&load_job.lock);
+
+		if (shutdown)
+			return;
+	}
+}
+
+/*******************************************************************************
+ * Default implementations of the platform hooks. Without platform support all
+ * copies are done by the primary CPU.
+ ******************************************************************************/
+#pragma weak bl2_plat_start_load_helpers
+#pragma weak bl2_plat_stop_load_helpers
+
+unsigned int bl2_plat_start_load_helpers(void)
+{
+	return 0;
+}
+
+void bl2_plat_stop_load_helpers(void)
+{
+}
+
+/*******************************************************************************
+ * Copy an image from its memory-mapped source and flush it to memory,
+ * sharing the work with the helper CPUs. This overrides the single CPU
+ * version in bl_common.c. It returns only when every chunk is complete.
+ ******************************************************************************/
+void copy_image(uintptr_t dst, uintptr_t src, size_t size)
+{
+	size_t completed;
+
+	if ((load_job.helpers == 0) || (size <= LOAD_CHUNK_SIZE)) {
+		memcpy((void *)dst, (const void *)src, size);
+		flush_dcache_range(dst, size);
+		return;
+	}
+
+	spin_lock(&load_job.lock);
+	load_job.dst = dst;
+	load_job.src = src;
+	load_job.size = size;
+	load_job.next = 0;
+	load_job.completed = 0;
+	spin_unlock(&load_job.lock);
+
+	/* Wake the helpers and take a share of the work */
+	dsb();
+	sev();
+	process_chunks();
+
+	/* Join: wait for the chunks claimed by the helpers */
+	do {
+		spin_lock(&load_job.lock);
+		completed = load_job.completed;
+		spin_unlock(&load_job.lock);
+	} while (completed < size);
+}
+
+/*******************************************************************************
+ * Start the helper CPUs before the images are loaded.
+ ******************************************************************************/
+void bl2_parallel_load_init(void)
+{
+	unsigned int helpers;
+
+	helpers = bl2_plat_start_load_helpers();
+	assert(helpers < PLATFORM_CORE_COUNT);
+
+	spin_lock(&load_job.lock);
+	load_job.helpers = helpers;
+	load_job.shutdown = 0;
+	spin_unlock(&load_job.lock);
+
+	INFO("BL2: %u helper CPU(s) available for image loading\n", helpers);
+}
+
+/*******************************************************************************
+ * Release the helper CPUs once all images are loaded. BL2 must not hand over
+ * to BL3-1 while a helper may still execute BL2 code, so wait for each of them
+ * to leave bl2_load_helper_main() before asking the platform to park them.
+ ******************************************************************************/
+void bl2_parallel_load_exit(void)
+{
+	unsigned int helpers;
+
+	if (load_job.helpers == 0)
+		return;
+
+	spin_lock(&load_job.lock);
+	load_job.shutdown = 1;
+	spin_unlock(&load_job.lock);
+
+	dsb();
+	sev();
+
+	do {
+		spin_lock(&load_job.lock);
+		helpers = load_job.helpers;
+		spin_unlock(&load_job.lock);
+	} while (helpers != 0);
+
+	bl2_plat_stop_load_helpers();
+}
@@ -35,5 +35,7 @@
  * Function prototypes
  *****************************************/
 void bl2_arch_setup(void);
+void bl2_parallel_load_init(void);
+void bl2_parallel_load_exit(void);
 
 #endif /* __BL2_PRIVATE_H__ */
@@ -40,7 +40,6 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				bl31/aarch64/runtime_exceptions.S		\
 				bl31/aarch64/crash_reporting.S			\
 				lib/cpus/aarch64/cpu_helpers.S			\
-				lib/locks/bakery/bakery_lock.c			\
 				lib/locks/exclusive/spinlock.S			\
 				services/std_svc/std_svc_setup.c		\
 				services/std_svc/psci/psci_afflvl_off.c		\
@@ -49,6 +48,7 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				services/std_svc/psci/psci_common.c		\
 				services/std_svc/psci/psci_entry.S		\
 				services/std_svc/psci/psci_helpers.S		\
+				services/std_svc/psci/psci_idle.c		\
 				services/std_svc/psci/psci_main.c		\
 				services/std_svc/psci/psci_setup.c		\
 				services/std_svc/psci/psci_system_off.c
@@ -70,3 +70,90 @@ endif
 
 $(eval $(call assert_boolean,CRASH_REPORTING))
 $(eval $(call add_define,CRASH_REPORTING))
+
+# Flag used to serve trivial fast SMCs with leaf handlers called from the SMC
+# exception vector, without the full save and restore of the cpu context
+SMC_LEAF_HANDLERS	:=	0
+
+$(eval $(call assert_boolean,SMC_LEAF_HANDLERS))
+$(eval $(call add_define,SMC_LEAF_HANDLERS))
+
+# Flag used to register the generic SiP Service of BL3-1. The SiP range belongs
+# to the silicon provider, so it is left to the platform by default
+GENERIC_SIP_SVC		:=	0
+
+$(eval $(call assert_boolean,GENERIC_SIP_SVC))
+$(eval $(call add_define,GENERIC_SIP_SVC))
+
+ifeq (${GENERIC_SIP_SVC},1)
+BL31_SOURCES		+=	services/sip_svc/sip_svc_setup.c
+endif
+
+# Flag used to enable the per-cpu accounting of SMC calls and of the time spent
+# handling them in BL3-1
+SMC_STATS		:=	0
+
+$(eval $(call assert_boolean,SMC_STATS))
+$(eval $(call add_define,SMC_STATS))
+
+ifeq (${SMC_STATS},1)
+BL31_SOURCES		+=	bl31/smc_stats.c
+endif
+
+ifeq (${SMC_STATS}${GENERIC_SIP_SVC},10)
+  $(error "Error: SMC_STATS requires GENERIC_SIP_SVC to read the statistics")
+endif
+
+# Flag used to enable the per-cpu accounting of the PSCI power down states
+# entered with CPU_SUSPEND and the PSCI_STAT_RESIDENCY/PSCI_STAT_COUNT calls
+PSCI_STATS		:=	0
+
+$(eval $(call assert_boolean,PSCI_STATS))
+$(eval $(call add_define,PSCI_STATS))
+
+ifeq (${PSCI_STATS},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_stat.c
+endif
+
+# Flag used to manage the state of the PSCI affinity instances without taking
+# the lock of each affinity level when a cpu powers itself down or up
+PSCI_LOCKLESS_CPU_STATE	:=	0
+
+$(eval $(call assert_boolean,PSCI_LOCKLESS_CPU_STATE))
+$(eval $(call add_define,PSCI_LOCKLESS_CPU_STATE))
+
+# Flag used to let the normal world coordinate the suspension of clusters by
+# requesting it only from the last cpu running in them (OS-initiated mode)
+PSCI_OS_INIT_MODE	:=	0
+
+$(eval $(call assert_boolean,PSCI_OS_INIT_MODE))
+$(eval $(call add_define,PSCI_OS_INIT_MODE))
+
+ifeq (${PSCI_OS_INIT_MODE}${PSCI_LOCKLESS_CPU_STATE},11)
+  $(error "Error: PSCI_OS_INIT_MODE cannot be used with PSCI_LOCKLESS_CPU_STATE")
+endif
+
+# Flag used to switch the FP/SIMD registers between the secure and non-secure
+# worlds only when the world being entered accesses them, instead of on every
+# world switch
+CTX_LAZY_FPREGS		:=	0
+
+$(eval $(call assert_boolean,CTX_LAZY_FPREGS))
+$(eval $(call add_define,CTX_LAZY_FPREGS))
+
+ifeq (${CTX_LAZY_FPREGS}${CTX_INCLUDE_FPREGS},10)
+  $(error "Error: CTX_LAZY_FPREGS requires CTX_INCLUDE_FPREGS to be enabled")
+endif
+
+# Flag used to keep the ticket state of the bakery locks used in BL3-1 in
+# per-cpu, cache line sized slots in Normal memory instead of in the locks
+PERCPU_BAKERY_LOCKS	:=	0
+
+$(eval $(call assert_boolean,PERCPU_BAKERY_LOCKS))
+$(eval $(call add_define,PERCPU_BAKERY_LOCKS))
+
+ifeq (${PERCPU_BAKERY_LOCKS},1)
+BL31_SOURCES		+=	lib/locks/bakery/bakery_lock_percpu.c
+else
+BL31_SOURCES		+=	lib/locks/bakery/bakery_lock.c
+endif
@@ -38,6 +38,7 @@
 #include <platform.h>
 #include <runtime_svc.h>
 #include <string.h>
+#include <timestamp.h>
 
 /*******************************************************************************
  * This function pointer is used to initialise the BL32 image. It's initialized
@@ -71,6 +72,8 @@ void bl31_lib_init(void)
  ******************************************************************************/
 void bl31_main(void)
 {
+	TS_RECORD(TS_MAIN_ENTRY);
+
 	NOTICE("BL3-1: %s\n", version_string);
 	NOTICE("BL3-1: %s\n", build_message);
 
@@ -80,6 +83,8 @@ void bl31_main(void)
 	/* Perform platform setup in BL1 */
 	bl31_platform_setup();
 
+	TS_RECORD(TS_PLATFORM_SETUP_DONE);
+
 	/* Initialise helper libraries */
 	bl31_lib_init();
 
@@ -87,6 +92,8 @@ void bl31_main(void)
 	INFO("BL3-1: Initializing runtime services\n");
 	runtime_svc_init();
 
+	TS_RECORD(TS_RUNTIME_SVC_INIT_DONE);
+
 	/* Clean caches before re-entering normal world */
 	dcsw_op_all(DCCSW);
 
@@ -106,7 +113,14 @@ void bl31_main(void)
 	if (bl32_init) {
 		INFO("BL3-1: Initializing BL3-2\n");
 		(*bl32_init)();
+		TS_RECORD(TS_BL32_INIT_DONE);
 	}
+
+#if BOOT_TIMESTAMPS
+	TS_RECORD(TS_EXIT);
+	ts_dump();
+#endif
+
 	/*
 	 * We are ready to enter the next EL. Prepare entry into the image
 	 * corresponding to the desired security state after the next ERET.
@@ -87,6 +87,71 @@ void cm_set_context_by_mpidr(uint64_t mpidr, void *context, uint32_t security_st
 	set_cpu_data_by_mpidr(mpidr, cpu_context[security_state], context);
 }
 
+#if CTX_LAZY_FPREGS
+/*******************************************************************************
+ * This function makes the accesses to the FP/SIMD registers from the lower ELs
+ * trap to EL3 unless the FP/SIMD registers of this cpu currently hold the
+ * state of the given 'cpu_context'. It is called each time a context is
+ * programmed for exception return, so a world that does not use the FP/SIMD
+ * registers never pays for saving and restoring them.
+ ******************************************************************************/
+static void cm_fpregs_set_trap(void *context)
+{
+	uint64_t cptr_el3, trap;
+
+	cptr_el3 = read_cptr_el3();
+	trap = (get_cpu_data(fpregs_owner) == context) ? 0 : TFP_BIT;
+
+	if ((cptr_el3 & TFP_BIT) != trap)
+		write_cptr_el3((cptr_el3 & ~TFP_BIT) | trap);
+}
+
+/*******************************************************************************
+ * This function is called from the synchronous exception handler when a lower
+ * EL has accessed the FP/SIMD registers while they were trapped. It saves them
+ * in the 'cpu_context' that owns them, if any, loads them from the
+ * 'cpu_context' of the world that trapped and makes it their new owner. The
+ * trapped instruction is executed again upon exception return.
+ ******************************************************************************/
+void cm_fpregs_lazy_switch(void *context)
+{
+	void *owner = get_cpu_data(fpregs_owner);
+
+	assert(context);
+	assert(owner != context);
+
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	if (owner)
+		fpregs_context_save(get_fpregs_ctx(owner));
+	fpregs_context_restore(get_fpregs_ctx(context));
+
+	set_cpu_data(fpregs_owner, context);
+}
+
+/*******************************************************************************
+ * This function saves the FP/SIMD registers of the calling cpu in the
+ * 'cpu_context' that owns them before they lose their contents in a power down
+ * of the cpu. Either world will load them again at its first access after the
+ * cpu has been powered up. It must be called before the caches are flushed.
+ ******************************************************************************/
+void cm_fpregs_flush(void)
+{
+	void *owner = get_cpu_data(fpregs_owner);
+
+	if (!owner)
+		return;
+
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	fpregs_context_save(get_fpregs_ctx(owner));
+
+	set_cpu_data(fpregs_owner, NULL);
+}
+#endif
+
 /*******************************************************************************
  * This function is used to program the context that's used for exception
  * return. This initializes the SP_EL3 to a pointer to a 'cpu_context' set for
@@ -111,6 +176,10 @@ static inline void cm_set_next_context(void *context)
 			 "mov	sp, %0\n"
 			 "msr	spsel, #0\n"
 			 : : "r" (context));
+
+#if CTX_LAZY_FPREGS
+	cm_fpregs_set_trap(context);
+#endif
 }
 
 /*******************************************************************************
@@ -250,6 +319,9 @@ void cm_prepare_el3_exit(uint32_t security_state)
 			/* Enable EL1 access to timer */
 			write_cnthctl_el2(EL1PCEN_BIT | EL1PCTEN_BIT);
 
+			/* The virtual counter matches the physical one */
+			write_cntvoff_el2(0);
+
 			/* Set VPIDR, VMPIDR to match MIDR, MPIDR */
 			write_vpidr_el2(read_midr_el1());
 			write_vmpidr_el2(read_mpidr_el1());
@@ -286,6 +358,24 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
 }
 
+/*******************************************************************************
+ * This function saves only the volatile subset of the EL1 system register
+ * context, i.e. the exception return state, SP_EL1, ESR_EL1, FAR_EL1, PAR_EL1,
+ * CSSELR_EL1 and TPIDR_EL0, for the specified security state. A runtime service
+ * may use it instead of
+ * cm_el1_sysregs_context_save() when the other EL1 system registers of that
+ * security state are known not to have changed since they were last restored.
+ ******************************************************************************/
+void cm_el1_sysregs_context_save_volatile(uint32_t security_state)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+
+	el1_sysregs_context_save_volatile(get_sysregs_ctx(ctx));
+}
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
@@ -47,6 +47,20 @@
 uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 static rt_svc_desc_t *rt_svc_descs;
 
+#if SMC_LEAF_HANDLERS
+/*******************************************************************************
+ * The 'rt_svc_leaf_descs' array holds the leaf SMC handlers exported by services
+ * by placing them in the 'rt_svc_leaf_descs' linker section. Those whose runtime
+ * service has been initialised are copied to the 'rt_svc_leaves' array, which
+ * the SMC exception vector searches before dispatching an SMC to a runtime
+ * service.
+ ******************************************************************************/
+#define RT_SVC_LEAF_DESCS_START	((uint64_t) (&__RT_SVC_LEAF_DESCS_START__))
+#define RT_SVC_LEAF_DESCS_END	((uint64_t) (&__RT_SVC_LEAF_DESCS_END__))
+rt_svc_leaf_desc_t rt_svc_leaves[MAX_RT_SVC_LEAVES];
+uint32_t rt_svc_leaves_num;
+#endif
+
 /*******************************************************************************
  * Simple routine to sanity check a runtime service descriptor before using it
  ******************************************************************************/
@@ -71,6 +85,43 @@ static int32_t validate_rt_svc_desc(rt_svc_desc_t *desc)
 	return 0;
 }
 
+#if SMC_LEAF_HANDLERS
+/*******************************************************************************
+ * This function registers the leaf SMC handlers of the runtime services which
+ * have been initialised. A leaf handler for any other function id is ignored
+ * so that the SMC is rejected as usual.
+ ******************************************************************************/
+static void init_rt_svc_leaves(void)
+{
+	const rt_svc_leaf_desc_t *desc;
+	uint32_t smc_fid, idx;
+
+	for (desc = (const rt_svc_leaf_desc_t *) RT_SVC_LEAF_DESCS_START;
+	     desc < (const rt_svc_leaf_desc_t *) RT_SVC_LEAF_DESCS_END;
+	     desc++) {
+		smc_fid = desc->smc_fid;
+
+		if ((desc->handle == NULL) ||
+		    (GET_SMC_TYPE(smc_fid) != SMC_TYPE_FAST)) {
+			ERROR("Invalid leaf SMC handler for 0x%x\n", smc_fid);
+			panic();
+		}
+
+		idx = get_unique_oen((smc_fid >> FUNCID_OEN_SHIFT),
+				     SMC_TYPE_FAST);
+		if (rt_svc_descs_indices[idx] & 0x80)
+			continue;
+
+		if (rt_svc_leaves_num == MAX_RT_SVC_LEAVES) {
+			ERROR("Too many leaf SMC handlers\n");
+			panic();
+		}
+
+		rt_svc_leaves[rt_svc_leaves_num++] = *desc;
+	}
+}
+#endif
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -140,6 +191,9 @@ void runtime_svc_init(void)
 			rt_svc_descs_indices[start_idx] = index;
 	}
 
+#if SMC_LEAF_HANDLERS
+	init_rt_svc_leaves();
+#endif
 	return;
 error:
 	panic();
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cpu_data.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <smc_stats.h>
+#include <string.h>
+
+/* Combine the call type and OEN of a function ID as the SMC dispatcher does */
+#define SMC_STATS_UNIQUE_OEN(_fid)					\
+	((((_fid) >> FUNCID_OEN_SHIFT) & FUNCID_OEN_MASK) |		\
+	 (GET_SMC_TYPE(_fid) << FUNCID_OEN_WIDTH))
+
+/*******************************************************************************
+ * Account for an SMC which has just been handled on this CPU. This is called by
+ * the SMC dispatcher once the runtime service handler has returned, with the
+ * value of the system counter read before invoking it. Only the calling CPU
+ * updates its own statistics so no locking is needed.
+ ******************************************************************************/
+void smc_stats_record(uint32_t smc_fid, uint64_t start_ticks)
+{
+	smc_stats_entry_t *entry;
+	uint64_t ticks;
+	unsigned int i;
+
+	isb();
+	ticks = read_cntpct_el0() - start_ticks;
+	if (ticks > UINT32_MAX)
+		ticks = UINT32_MAX;
+
+	/*
+	 * Look for the slot of this function ID, claiming a free one if it is
+	 * the first call. The last slot catches everything else.
+	 */
+	entry = get_cpu_data(smc_stats).entries;
+	for (i = 0; i < SMC_STATS_MAX_FIDS - 1; i++, entry++) {
+		if (entry->count == 0) {
+			entry->smc_fid = smc_fid;
+			break;
+		}
+
+		if (entry->smc_fid == smc_fid)
+			break;
+	}
+
+	if (i == SMC_STATS_MAX_FIDS - 1)
+		entry->smc_fid = SMC_STATS_FID_OTHER;
+
+	if (entry->count == 0 || ticks < entry->min_ticks)
+		entry->min_ticks = ticks;
+	if (ticks > entry->max_ticks)
+		entry->max_ticks = ticks;
+	entry->total_ticks += ticks;
+	entry->count++;
+}
+
+/*******************************************************************************
+ * Return the statistics held in the given slot of a CPU, or NULL if the
+ * arguments are out of range. The slot is not updated atomically so a reader
+ * on another CPU may observe a call that is only partially accounted for.
+ ******************************************************************************/
+const smc_stats_entry_t *smc_stats_get_entry(uint32_t cpu_idx,
+					     uint32_t entry_idx)
+{
+	if ((cpu_idx >= PLATFORM_CORE_COUNT) ||
+	    (entry_idx >= SMC_STATS_MAX_FIDS))
+		return NULL;
+
+	return &get_cpu_data_by_index(cpu_idx, smc_stats).entries[entry_idx];
+}
+
+/*******************************************************************************
+ * Aggregate the statistics of a CPU for all the function IDs of an owning
+ * entity. 'oen' combines the call type and OEN as in the 'rt_svc_descs_indices'
+ * array. Calls accounted in the shared last slot are not included.
+ ******************************************************************************/
+int smc_stats_get_oen(uint32_t cpu_idx, uint32_t oen,
+		      smc_stats_entry_t *result)
+{
+	const smc_stats_entry_t *entry;
+	unsigned int i;
+
+	assert(result != NULL);
+
+	if ((cpu_idx >= PLATFORM_CORE_COUNT) || (oen >= MAX_RT_SVCS))
+		return -EINVAL;
+
+	memset(result, 0, sizeof(*result));
+	result->smc_fid = oen;
+
+	entry = get_cpu_data_by_index(cpu_idx, smc_stats).entries;
+	for (i = 0; i < SMC_STATS_MAX_FIDS - 1; i++, entry++) {
+		if ((entry->count == 0) ||
+		    (SMC_STATS_UNIQUE_OEN(entry->smc_fid) != oen))
+			continue;
+
+		if ((result->count == 0) ||
+		    (entry->min_ticks < result->min_ticks))
+			result->min_ticks = entry->min_ticks;
+		if (entry->max_ticks > result->max_ticks)
+			result->max_ticks = entry->max_ticks;
+		result->total_ticks += entry->total_ticks;
+		result->count += entry->count;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Clear the statistics of a CPU
+ ******************************************************************************/
+void smc_stats_reset(uint32_t cpu_idx)
+{
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	memset(&get_cpu_data_by_index(cpu_idx, smc_stats), 0,
+	       sizeof(smc_stats_t));
+}
@@ -37,7 +37,8 @@ BL32_SOURCES		+=	bl32/tsp/tsp_main.c			\
 				bl32/tsp/tsp_interrupt.c		\
 				bl32/tsp/tsp_timer.c			\
 				common/aarch64/early_exceptions.S	\
-				lib/locks/exclusive/spinlock.S
+				lib/locks/exclusive/spinlock.S		\
+				lib/locks/exclusive/ticket_lock.S
 
 BL32_LINKERFILE		:=	bl32/tsp/tsp.ld.S
 
@@ -49,6 +50,13 @@ TSP_INIT_ASYNC         :=      0
 $(eval $(call assert_boolean,TSP_INIT_ASYNC))
 $(eval $(call add_define,TSP_INIT_ASYNC))
 
+# This flag makes the TSP measure and report the round trip latency of a leaf
+# SMC and of a SMC dispatched to a runtime service during its initialisation.
+TSP_SMC_BENCHMARK	:=	0
+
+$(eval $(call assert_boolean,TSP_SMC_BENCHMARK))
+$(eval $(call add_define,TSP_SMC_BENCHMARK))
+
 # Include the platform-specific TSP Makefile
 # If no platform-specific TSP Makefile exists, it means TSP is not supported
 # on this platform.
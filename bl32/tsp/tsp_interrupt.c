@@ -57,14 +57,14 @@ void tsp_update_sync_fiq_stats(uint32_t type, uint64_t elr_el3)
 		tsp_stats[linear_id].sync_fiq_ret_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	VERBOSE("TSP: cpu 0x%x sync fiq request from 0x%llx\n",
 		mpidr, elr_el3);
 	VERBOSE("TSP: cpu 0x%x: %d sync fiq requests, %d sync fiq returns\n",
 		mpidr,
 		tsp_stats[linear_id].sync_fiq_count,
 		tsp_stats[linear_id].sync_fiq_ret_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 }
 
@@ -79,6 +79,9 @@ int32_t tsp_fiq_handler(void)
 {
 	uint64_t mpidr = read_mpidr();
 	uint32_t linear_id = platform_get_core_pos(mpidr), id;
+#if TSP_SMC_BENCHMARK
+	uint64_t now = read_cntpct_el0();
+#endif
 
 	/*
 	 * Get the highest priority pending interrupt id and see if it is the
@@ -97,18 +100,25 @@ int32_t tsp_fiq_handler(void)
 	 */
 	id = plat_ic_acknowledge_interrupt();
 	assert(id == TSP_IRQ_SEC_PHY_TIMER);
+#if TSP_SMC_BENCHMARK
+	/* The compare value is when the timer asserted the interrupt */
+	now -= read_cntps_cval_el1();
+#endif
 	tsp_generic_timer_handler();
 	plat_ic_end_of_interrupt(id);
+#if TSP_SMC_BENCHMARK
+	tsp_fiq_latency(now);
+#endif
 
 	/* Update the statistics and print some messages */
 	tsp_stats[linear_id].fiq_count++;
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	VERBOSE("TSP: cpu 0x%x handled fiq %d\n",
 	       mpidr, id);
 	VERBOSE("TSP: cpu 0x%x: %d fiq requests\n",
 	     mpidr, tsp_stats[linear_id].fiq_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 	return 0;
 }
@@ -120,11 +130,11 @@ int32_t tsp_irq_received(void)
 
 	tsp_stats[linear_id].irq_count++;
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	VERBOSE("TSP: cpu 0x%x received irq\n", mpidr);
 	VERBOSE("TSP: cpu 0x%x: %d irq requests\n",
 		mpidr, tsp_stats[linear_id].irq_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 	return TSP_PREEMPTED;
 }
@@ -34,7 +34,6 @@
 #include <platform.h>
 #include <platform_def.h>
 #include <platform_tsp.h>
-#include <spinlock.h>
 #include <tsp.h>
 #include "tsp_private.h"
 
@@ -48,7 +47,7 @@ extern unsigned long __COHERENT_RAM_END__;
 /*******************************************************************************
  * Lock to control access to the console
  ******************************************************************************/
-spinlock_t console_lock;
+console_lock_t console_lock;
 
 /*******************************************************************************
  * Per cpu data structure to populate parameters for an SMC in C code and use
@@ -100,6 +99,126 @@ static tsp_args_t *set_smc_args(uint64_t arg0,
 	return pcpu_smc_args;
 }
 
+#if TSP_SMC_BENCHMARK
+#define TSP_SMC_BENCHMARK_SAMPLES	256
+
+static uint32_t tsp_smc_samples[PLATFORM_CORE_COUNT][TSP_SMC_BENCHMARK_SAMPLES];
+static uint32_t tsp_smc_cycles[PLATFORM_CORE_COUNT][TSP_SMC_BENCHMARK_SAMPLES];
+static uint32_t tsp_fiq_samples[PLATFORM_CORE_COUNT][TSP_SMC_BENCHMARK_SAMPLES];
+static uint32_t tsp_fiq_sample_count[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Insert a sample into the first 'count' entries of an array of samples, which
+ * are kept sorted as they are collected.
+ ******************************************************************************/
+static void tsp_latency_insert(uint32_t *samples, unsigned int count,
+			       uint32_t sample)
+{
+	unsigned int i;
+
+	for (i = count; i > 0 && samples[i - 1] > sample; i--)
+		samples[i] = samples[i - 1];
+	samples[i] = sample;
+}
+
+/*******************************************************************************
+ * Report the minimum, the median, the 90th and 99th percentiles and the
+ * maximum of a full, sorted array of samples measured in the given unit.
+ ******************************************************************************/
+static void tsp_latency_report(const char *name, const uint32_t *samples,
+			       const char *unit)
+{
+	console_lock_get(&console_lock);
+	NOTICE("TSP: cpu 0x%x: %s: min %u, median %u, "
+	       "p90 %u, p99 %u, max %u %s\n", read_mpidr(), name,
+	       samples[0],
+	       samples[TSP_SMC_BENCHMARK_SAMPLES / 2],
+	       samples[TSP_SMC_BENCHMARK_SAMPLES * 90 / 100],
+	       samples[TSP_SMC_BENCHMARK_SAMPLES * 99 / 100],
+	       samples[TSP_SMC_BENCHMARK_SAMPLES - 1], unit);
+	console_lock_release(&console_lock);
+}
+
+/*******************************************************************************
+ * Measure the round trip latency, in ticks of the system counter and in cpu
+ * cycles, of each of a number of SMCs with the given function id issued by the
+ * calling cpu.
+ ******************************************************************************/
+static void tsp_smc_latency(const char *name, uint32_t smc_fid)
+{
+	uint32_t *samples, *cycles, linear_id;
+	uint64_t start, start_cycles, end, end_cycles;
+	unsigned int i;
+
+	linear_id = platform_get_core_pos(read_mpidr());
+	samples = tsp_smc_samples[linear_id];
+	cycles = tsp_smc_cycles[linear_id];
+
+	for (i = 0; i < TSP_SMC_BENCHMARK_SAMPLES; i++) {
+		isb();
+		start = read_cntpct_el0();
+		start_cycles = read_pmccntr_el0();
+		tsp_smc(smc_fid);
+		isb();
+		end_cycles = read_pmccntr_el0();
+		end = read_cntpct_el0();
+		tsp_latency_insert(samples, i, end - start);
+		tsp_latency_insert(cycles, i, end_cycles - start_cycles);
+	}
+
+	tsp_latency_report(name, samples, "ticks");
+	tsp_latency_report(name, cycles, "cycles");
+}
+
+/*******************************************************************************
+ * Record the time, in ticks of the system counter, between the secure physical
+ * timer asserting its interrupt and the TSP FIQ handler being entered. This
+ * covers the routing of the S-EL1 FIQ through BL3-1 when it is taken in the
+ * normal world. The samples are reported each time enough have been collected
+ * on the calling cpu.
+ ******************************************************************************/
+void tsp_fiq_latency(uint32_t sample)
+{
+	uint32_t linear_id = platform_get_core_pos(read_mpidr());
+	uint32_t count = tsp_fiq_sample_count[linear_id];
+	uint32_t *samples = tsp_fiq_samples[linear_id];
+
+	tsp_latency_insert(samples, count, sample);
+	if (++count == TSP_SMC_BENCHMARK_SAMPLES) {
+		tsp_latency_report("S-EL1 FIQ entry", samples, "ticks");
+		count = 0;
+	}
+
+	tsp_fiq_sample_count[linear_id] = count;
+}
+
+/*******************************************************************************
+ * Compare the latency of TOS_CALL_COUNT, which the TSPD serves with a leaf SMC
+ * handler when SMC_LEAF_HANDLERS is enabled, with that of TOS_CALL_VERSION,
+ * which always goes through the full runtime service dispatch. Both handlers
+ * do a comparable amount of work.
+ ******************************************************************************/
+static void tsp_smc_benchmark(void)
+{
+	/*
+	 * Start the cycle counter. It counts in the secure world as the TSPD
+	 * sets MDCR_EL3.SPME in the benchmark builds.
+	 */
+	write_pmccfiltr_el0(0);
+	write_pmcntenset_el0(PMCNTENSET_EL0_C_BIT);
+	write_pmcr_el0(read_pmcr_el0() | PMCR_EL0_E_BIT);
+	isb();
+
+#if SMC_LEAF_HANDLERS
+	tsp_smc_latency("TOS_CALL_COUNT leaf round trip", TOS_CALL_COUNT);
+#else
+	tsp_smc_latency("TOS_CALL_COUNT dispatched round trip", TOS_CALL_COUNT);
+#endif
+	tsp_smc_latency("TOS_CALL_VERSION dispatched round trip",
+			TOS_CALL_VERSION);
+}
+#endif
+
 /*******************************************************************************
  * TSP main entry point where it gets the opportunity to initialize its secure
  * state/applications. Once the state is initialized, it must return to the
@@ -122,18 +241,22 @@ uint64_t tsp_main(void)
 	/* Initialize secure/applications state here */
 	tsp_generic_timer_start();
 
+#if TSP_SMC_BENCHMARK
+	tsp_smc_benchmark();
+#endif
+
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
 	tsp_stats[linear_id].cpu_on_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets %d cpu on requests\n", mpidr,
 	     tsp_stats[linear_id].smc_count,
 	     tsp_stats[linear_id].eret_count,
 	     tsp_stats[linear_id].cpu_on_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 	return (uint64_t) &tsp_vector_table;
 }
@@ -151,19 +274,23 @@ tsp_args_t *tsp_cpu_on_main(void)
 	/* Initialize secure/applications state here */
 	tsp_generic_timer_start();
 
+#if TSP_SMC_BENCHMARK
+	tsp_smc_benchmark();
+#endif
+
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
 	tsp_stats[linear_id].cpu_on_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x turned on\n", mpidr);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets %d cpu on requests\n", mpidr,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count,
 		tsp_stats[linear_id].cpu_on_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 	/* Indicate to the SPD that we have completed turned ourselves on */
 	return set_smc_args(TSP_ON_DONE, 0, 0, 0, 0, 0, 0, 0);
@@ -198,13 +325,13 @@ tsp_args_t *tsp_cpu_off_main(uint64_t arg0,
 	tsp_stats[linear_id].cpu_off_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x off request\n", mpidr);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets %d cpu off requests\n", mpidr,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count,
 		tsp_stats[linear_id].cpu_off_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 
 	/* Indicate to the SPD that we have completed this request */
@@ -241,7 +368,7 @@ tsp_args_t *tsp_cpu_suspend_main(uint64_t power_state,
 	tsp_stats[linear_id].cpu_suspend_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x suspend request. power state: 0x%x\n",
 		mpidr, power_state);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets %d cpu suspend requests\n",
@@ -249,7 +376,7 @@ tsp_args_t *tsp_cpu_suspend_main(uint64_t power_state,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count,
 		tsp_stats[linear_id].cpu_suspend_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 
 	/* Indicate to the SPD that we have completed this request */
@@ -282,7 +409,7 @@ tsp_args_t *tsp_cpu_resume_main(uint64_t suspend_level,
 	tsp_stats[linear_id].cpu_resume_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x resumed. suspend level %d\n",
 		mpidr, suspend_level);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets %d cpu suspend requests\n",
@@ -290,7 +417,7 @@ tsp_args_t *tsp_cpu_resume_main(uint64_t suspend_level,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count,
 		tsp_stats[linear_id].cpu_suspend_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 	/* Indicate to the SPD that we have completed this request */
 	return set_smc_args(TSP_RESUME_DONE, 0, 0, 0, 0, 0, 0, 0);
@@ -317,12 +444,12 @@ tsp_args_t *tsp_system_off_main(uint64_t arg0,
 	tsp_stats[linear_id].eret_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x SYSTEM_OFF request\n", mpidr);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets requests\n", mpidr,
 	     tsp_stats[linear_id].smc_count,
 	     tsp_stats[linear_id].eret_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 
 	/* Indicate to the SPD that we have completed this request */
@@ -350,12 +477,12 @@ tsp_args_t *tsp_system_reset_main(uint64_t arg0,
 	tsp_stats[linear_id].eret_count++;
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-	spin_lock(&console_lock);
+	console_lock_get(&console_lock);
 	INFO("TSP: cpu 0x%x SYSTEM_RESET request\n", mpidr);
 	INFO("TSP: cpu 0x%x: %d smcs, %d erets requests\n", mpidr,
 	     tsp_stats[linear_id].smc_count,
 	     tsp_stats[linear_id].eret_count);
-	spin_unlock(&console_lock);
+	console_lock_release(&console_lock);
 #endif
 
 	/* Indicate to the SPD that we have completed this request */
@@ -386,6 +513,28 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
 
+	/*
+	 * The null service lets normal world clients measure the round trip
+	 * latency of a call into the TSP, so it skips the logging and the
+	 * request for more arguments below. A fast call returns immediately.
+	 * A standard call first waits for the number of ticks of the system
+	 * counter given in arg1, up to TSP_NULL_MAX_DELAY, during which it can
+	 * be preempted and later resumed with TSP_FID_RESUME.
+	 */
+	if (TSP_BARE_FID(func) == TSP_NULL) {
+		if (func == TSP_STD_FID(TSP_NULL)) {
+			uint64_t start = read_cntpct_el0();
+
+			if (arg1 > TSP_NULL_MAX_DELAY)
+				arg1 = TSP_NULL_MAX_DELAY;
+
+			while (read_cntpct_el0() - start < arg1)
+				;
+		}
+
+		return set_smc_args(func, 0, 0, 0, 0, 0, 0, 0);
+	}
+
 	INFO("TSP: cpu 0x%x received %s smc 0x%x\n", read_mpidr(),
 		((func >> 31) & 1) == 1 ? "fast" : "standard",
 		func);
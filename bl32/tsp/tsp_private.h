@@ -50,8 +50,23 @@
 #include <platform_def.h> /* For CACHE_WRITEBACK_GRANULE */
 #include <spinlock.h>
 #include <stdint.h>
+#include <ticket_lock.h>
 #include <tsp.h>
 
+/*
+ * Lock serialising the accesses to the console. The TSP only takes it with
+ * the MMU and data cache enabled, so it can be a ticket lock which serves the
+ * cpus in order.
+ */
+#if USE_TICKET_LOCKS
+typedef ticket_lock_t console_lock_t;
+#define console_lock_get(_l)		ticket_lock_get(_l)
+#define console_lock_release(_l)	ticket_lock_release(_l)
+#else
+typedef spinlock_t console_lock_t;
+#define console_lock_get(_l)		spin_lock(_l)
+#define console_lock_release(_l)	spin_unlock(_l)
+#endif
 
 typedef struct work_statistics {
 	uint32_t fiq_count;		/* Number of FIQs on this cpu */
@@ -81,6 +96,10 @@ typedef struct tsp_args {
 CASSERT(TSP_ARGS_SIZE == sizeof(tsp_args_t), assert_sp_args_size_mismatch);
 
 void tsp_get_magic(uint64_t args[4]);
+uint64_t tsp_smc(uint32_t smc_fid);
+#if TSP_SMC_BENCHMARK
+void tsp_fiq_latency(uint32_t sample);
+#endif
 
 tsp_args_t *tsp_cpu_resume_main(uint64_t arg0,
 				uint64_t arg1,
@@ -120,7 +139,7 @@ void tsp_update_sync_fiq_stats(uint32_t type, uint64_t elr_el3);
 
 
 /* Data structure to keep track of TSP statistics */
-extern spinlock_t console_lock;
+extern console_lock_t console_lock;
 extern work_statistics_t tsp_stats[PLATFORM_CORE_COUNT];
 
 /* Vector table of jumps */
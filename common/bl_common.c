@@ -35,7 +35,11 @@
 #include <debug.h>
 #include <errno.h>
 #include <io_storage.h>
+#include <lz4.h>
 #include <platform.h>
+#include <sha256.h>
+#include <string.h>
+#include <timestamp.h>
 
 unsigned long page_align(unsigned long value, unsigned dir)
 {
@@ -155,6 +159,85 @@ static void dump_load_info(unsigned long image_load_addr,
 			mem_layout->free_base + mem_layout->free_size);
 }
 
+/*******************************************************************************
+ * Copy an image from a memory-mapped source to its load address and flush it
+ * so that the next EL can see it. BL2 replaces this function to share the
+ * work between several CPUs when BL2_PARALLEL_LOAD is enabled.
+ ******************************************************************************/
+#pragma weak copy_image
+
+void copy_image(uintptr_t dst, uintptr_t src, size_t size)
+{
+	memcpy((void *)dst, (const void *)src, size);
+	flush_dcache_range(dst, size);
+}
+
+/*******************************************************************************
+ * When MEASURED_BOOT is enabled, images are hashed as they are loaded, this
+ * many bytes at a time. Each chunk is hashed while it is still in the data
+ * cache, rather than the whole image being read back once it is loaded.
+ ******************************************************************************/
+#define LOAD_HASH_CHUNK_SIZE	(8 * 1024)
+
+static void hash_image_chunk(sha256_ctx_t *hash, uintptr_t base, size_t size)
+{
+#if MEASURED_BOOT
+	if (hash != NULL)
+		sha256_update(hash, (const void *)base, size);
+#endif
+}
+
+/*******************************************************************************
+ * Load an image from a memory-mapped source and flush it. Without a hash this
+ * is left to copy_image().
+ ******************************************************************************/
+static void load_image_from_memory(uintptr_t dst, uintptr_t src, size_t size,
+				   sha256_ctx_t *hash)
+{
+	size_t n;
+
+	if (hash == NULL) {
+		copy_image(dst, src, size);
+		return;
+	}
+
+	for (; size != 0; size -= n, dst += n, src += n) {
+		n = (size < LOAD_HASH_CHUNK_SIZE) ? size : LOAD_HASH_CHUNK_SIZE;
+		memcpy((void *)dst, (const void *)src, n);
+		hash_image_chunk(hash, dst, n);
+		flush_dcache_range(dst, n);
+	}
+}
+
+/*******************************************************************************
+ * Load an image through the IO layer and flush it. Without a hash the image
+ * is read in one go.
+ ******************************************************************************/
+static int load_image_from_device(uintptr_t handle, uintptr_t dst, size_t size,
+				  sha256_ctx_t *hash)
+{
+	size_t n, bytes_read;
+	int io_result;
+
+	n = (hash == NULL) ? size : LOAD_HASH_CHUNK_SIZE;
+	for (; size != 0; size -= n, dst += n) {
+		if (n > size)
+			n = size;
+
+		/* TODO: Consider whether to try to recover/retry a partially successful read */
+		io_result = io_read(handle, dst, n, &bytes_read);
+		if (io_result != IO_SUCCESS)
+			return io_result;
+		if (bytes_read < n)
+			return IO_FAIL;
+
+		hash_image_chunk(hash, dst, n);
+		flush_dcache_range(dst, n);
+	}
+
+	return IO_SUCCESS;
+}
+
 /* Generic function to return the size of an image */
 unsigned long image_size(const char *image_name)
 {
@@ -162,6 +245,8 @@ unsigned long image_size(const char *image_name)
 	uintptr_t image_handle;
 	uintptr_t image_spec;
 	size_t image_size = 0;
+	size_t decoded_size;
+	io_encoding_t encoding;
 	int io_result = IO_FAIL;
 
 	assert(image_name != NULL);
@@ -188,14 +273,19 @@ unsigned long image_size(const char *image_name)
 		WARN("Failed to determine the size of the image '%s' file (%i)\n",
 			image_name, io_result);
 	}
+
+	/* A compressed image takes up its decoded size once loaded */
+	if (io_get_encoding(image_handle, &encoding, &decoded_size) ==
+	    IO_SUCCESS)
+		image_size = decoded_size;
+
 	io_result = io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this
-	 * bootloader stage
+	/* The device connection is maintained for the rest of this bootloader
+	 * stage so that drivers can keep state, e.g. the FIP Table of
+	 * Contents, across image accesses.
 	 */
-	io_result = io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
 
 	return image_size;
 }
@@ -218,15 +308,27 @@ int load_image(meminfo_t *mem_layout,
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
 	uintptr_t image_spec;
+	uintptr_t image_addr;
 	size_t image_size;
-	size_t bytes_read;
+	size_t stored_size;
+	io_encoding_t encoding;
+	int is_direct;
 	int io_result = IO_FAIL;
+#if MEASURED_BOOT
+	/* load_image() is never re-entered, so keep this off the stack */
+	static sha256_ctx_t hash_ctx;
+	sha256_ctx_t *hash = &hash_ctx;
+#else
+	sha256_ctx_t *hash = NULL;
+#endif
 
 	assert(mem_layout != NULL);
 	assert(image_name != NULL);
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_1);
 
+	TS_RECORD(TS_IMAGE_LOAD_START);
+
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_name, &dev_handle, &image_spec);
 	if (io_result != IO_SUCCESS) {
@@ -253,6 +355,37 @@ int load_image(meminfo_t *mem_layout,
 		goto exit;
 	}
 
+	/*
+	 * A compressed image is decoded as it is read, so the memory checks
+	 * below must use its decoded size. Devices that cannot report an
+	 * encoding store images as they are.
+	 */
+	stored_size = image_size;
+	io_result = io_get_encoding(image_handle, &encoding, &image_size);
+	if (io_result != IO_SUCCESS) {
+		encoding = IO_ENCODING_NONE;
+		image_size = stored_size;
+	}
+
+	/*
+	 * If the device exposes the image in place at its link address, e.g.
+	 * a FIP in memory-mapped NOR flash, there is nothing to copy. The
+	 * image was not written by this stage so it needs no cache
+	 * maintenance either, and it does not consume any free memory.
+	 */
+	io_result = io_get_direct_address(image_handle, &image_addr);
+	is_direct = (io_result == IO_SUCCESS) &&
+		(encoding == IO_ENCODING_NONE);
+#if MEASURED_BOOT
+	sha256_init(hash);
+#endif
+	if (is_direct && (image_addr == image_base)) {
+		INFO("File '%s' executes in place at 0x%lx\n", image_name,
+		     image_base);
+		hash_image_chunk(hash, image_base, image_size);
+		goto loaded;
+	}
+
 	/* Check that the memory where the image will be loaded is free */
 	if (!is_mem_free(mem_layout->free_base, mem_layout->free_size,
 			 image_base, image_size)) {
@@ -264,11 +397,48 @@ int load_image(meminfo_t *mem_layout,
 	}
 
 	/* We have enough space so load the image now */
-	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
-	if ((io_result != IO_SUCCESS) || (bytes_read < image_size)) {
-		WARN("Failed to load '%s' file (%i)\n", image_name, io_result);
+	if (encoding != IO_ENCODING_NONE) {
+#if LOAD_COMPRESSED_IMAGES
+		/*
+		 * Decompress straight to the load address, pulling the
+		 * compressed data through the IO layer a chunk at a time.
+		 * The decoder hashes the output as it produces it.
+		 */
+		assert(encoding == IO_ENCODING_LZ4);
+		io_result = lz4_decode_stream(image_handle, stored_size,
+					      image_base, image_size, hash);
+		if (io_result != 0) {
+			WARN("Failed to decompress '%s' file (%i)\n",
+			     image_name, io_result);
+			goto exit;
+		}
+		flush_dcache_range(image_base, image_size);
+#else
+		WARN("File '%s' is compressed but LOAD_COMPRESSED_IMAGES=0\n",
+		     image_name);
+		io_result = IO_NOT_SUPPORTED;
 		goto exit;
+#endif
+	} else if (is_direct) {
+		/*
+		 * The image is memory-mapped, so copy it without going through
+		 * the IO layer. This also flushes it to memory.
+		 */
+		load_image_from_memory(image_base, image_addr, image_size,
+				       hash);
+		io_result = IO_SUCCESS;
+	} else {
+		/*
+		 * Read the image and flush it in TZRAM so that the next EL
+		 * can see it.
+		 */
+		io_result = load_image_from_device(image_handle, image_base,
+						   image_size, hash);
+		if (io_result != IO_SUCCESS) {
+			WARN("Failed to load '%s' file (%i)\n", image_name,
+			     io_result);
+			goto exit;
+		}
 	}
 
 	/*
@@ -279,28 +449,28 @@ int load_image(meminfo_t *mem_layout,
 	reserve_mem(&mem_layout->free_base, &mem_layout->free_size,
 		    image_base, image_size);
 
+	INFO("File '%s' loaded: 0x%lx - 0x%lx\n", image_name, image_base,
+	     image_base + image_size);
+
+loaded:
 	image_data->image_base = image_base;
 	image_data->image_size = image_size;
+#if MEASURED_BOOT
+	sha256_final(hash, image_data->digest);
+#endif
 
 	if (entry_point_info != NULL)
 		entry_point_info->pc = image_base;
 
-	/*
-	 * File has been successfully loaded.
-	 * Flush the image in TZRAM so that the next EL can see it.
-	 */
-	flush_dcache_range(image_base, image_size);
-
-	INFO("File '%s' loaded: 0x%lx - 0x%lx\n", image_name, image_base,
-	     image_base + image_size);
-
 exit:
+	TS_RECORD(TS_IMAGE_LOAD_DONE);
+
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
+	/* The device connection is maintained for the rest of this bootloader
+	 * stage, see image_size().
+	 */
 
 	return io_result;
 }
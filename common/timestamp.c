@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <string.h>
+#include <timestamp.h>
+
+ts_table_t ts_table;
+
+static const char *const ts_names[TS_MAX_ID] = {
+	[TS_MAIN_ENTRY] = "main entry",
+	[TS_PLATFORM_SETUP_DONE] = "platform setup done",
+	[TS_XLAT_START] = "xlat tables start",
+	[TS_XLAT_DONE] = "xlat tables done",
+	[TS_SECURITY_SETUP_START] = "security setup start",
+	[TS_SECURITY_SETUP_DONE] = "security setup done",
+	[TS_IMAGE_LOAD_START] = "image load start",
+	[TS_IMAGE_LOAD_DONE] = "image load done",
+	[TS_RUNTIME_SVC_INIT_DONE] = "runtime services init done",
+	[TS_BL32_INIT_DONE] = "BL3-2 init done",
+	[TS_EXIT] = "exit",
+};
+
+/*******************************************************************************
+ * Take over the probes recorded by the previous boot stage. This must be
+ * called before this stage records its own probes. 'from' may be NULL if the
+ * previous stage did not pass a table.
+ ******************************************************************************/
+void ts_import(const ts_table_t *from)
+{
+	if ((from == NULL) || (from->num_entries > TS_MAX_ENTRIES))
+		return;
+
+	memcpy(&ts_table, from, sizeof(ts_table));
+}
+
+/*******************************************************************************
+ * Copy the probes recorded so far to memory handed over to the next boot
+ * stage and flush them so they can be read with the MMU off.
+ ******************************************************************************/
+void ts_export(ts_table_t *to)
+{
+	if (to == NULL)
+		return;
+
+	memcpy(to, &ts_table, sizeof(ts_table));
+	flush_dcache_range((unsigned long)to, sizeof(ts_table));
+}
+
+/*******************************************************************************
+ * Print the probes recorded so far with the time elapsed since the previous
+ * one.
+ ******************************************************************************/
+void ts_dump(void)
+{
+	unsigned int i;
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t prev = 0;
+	uint64_t delta;
+	const ts_entry_t *entry;
+	const char *name;
+
+	tf_printf("Boot timestamps (counter frequency %lu Hz):\n", freq);
+
+	for (i = 0; i < ts_table.num_entries; i++) {
+		entry = &ts_table.entries[i];
+		delta = (i == 0) ? 0 : entry->timestamp - prev;
+		prev = entry->timestamp;
+
+		name = (entry->id < TS_MAX_ID) ? ts_names[entry->id] : "unknown";
+
+		if (freq != 0)
+			tf_printf("  BL%u %s: %lu (+%lu us)\n", entry->image,
+				  name, entry->timestamp,
+				  (delta * 1000000) / freq);
+		else
+			tf_printf("  BL%u %s: %lu (+%lu ticks)\n", entry->image,
+				  name, entry->timestamp, delta);
+	}
+}
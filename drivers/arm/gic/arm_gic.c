@@ -38,6 +38,7 @@
 #include <gic_v3.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <stdint.h>
 
 
@@ -47,6 +48,56 @@ static unsigned long g_gicr_base;
 static const unsigned int *g_irq_sec_ptr;
 static unsigned int g_num_irqs;
 
+/*
+ * Redistributor frame of each cpu, looked up the first time it is needed. Each
+ * entry has a cache line of its own, so that cleaning or invalidating one
+ * entry, or writing it with the data cache disabled, does not affect the entry
+ * of another cpu.
+ */
+typedef struct rdist_base {
+	uintptr_t base;
+} __aligned(CACHE_WRITEBACK_GRANULE) rdist_base_t;
+
+static rdist_base_t g_rdist_base[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function returns the base address of the GICv3 redistributor frame of
+ * the calling cpu. The frame is looked up only the first time, using its
+ * position in the frames if the platform lays them out in the order of the
+ * core positions, and by scanning the frames otherwise. The result is cleaned
+ * to the point of coherency so that it can also be read with the data cache
+ * disabled, e.g. when the cpu is being powered down.
+ ******************************************************************************/
+static uintptr_t gicv3_get_pcpu_rdist(void)
+{
+	uint64_t mpidr = read_mpidr();
+	unsigned int core_pos = platform_get_core_pos(mpidr);
+	uintptr_t base;
+
+	base = g_rdist_base[core_pos].base;
+	if (base)
+		return base;
+
+	assert(g_gicr_base);
+#ifdef PLAT_GICR_FRAMES_IN_CORE_POS_ORDER
+	base = gicv3_get_rdist_at(g_gicr_base, core_pos, mpidr);
+	if (base == (uintptr_t)NULL)
+#endif
+		base = gicv3_get_rdist(g_gicr_base, mpidr);
+
+	if (base == (uintptr_t)NULL) {
+		/* No re-distributor base address. This interface cannot be
+		 * configured.
+		 */
+		panic();
+	}
+
+	g_rdist_base[core_pos].base = base;
+	flush_dcache_range((uint64_t) &g_rdist_base[core_pos],
+			   sizeof(g_rdist_base[core_pos]));
+
+	return base;
+}
 
 /*******************************************************************************
  * This function does some minimal GICv3 configuration. The Firmware itself does
@@ -67,14 +118,7 @@ static void gicv3_cpuif_setup(void)
 	 * GICR_WAKER is NOT banked per CPU, compute the correct base address
 	 * per CPU.
 	 */
-	assert(g_gicr_base);
-	base = gicv3_get_rdist(g_gicr_base, read_mpidr());
-	if (base == (uintptr_t)NULL) {
-		/* No re-distributor base address. This interface cannot be
-		 * configured.
-		 */
-		panic();
-	}
+	base = gicv3_get_pcpu_rdist();
 
 	val = gicr_read_waker(base);
 
@@ -134,14 +178,7 @@ static void gicv3_cpuif_deactivate(void)
 	 * GICR_WAKER is NOT banked per CPU, compute the correct base address
 	 * per CPU.
 	 */
-	assert(g_gicr_base);
-	base = gicv3_get_rdist(g_gicr_base, read_mpidr());
-	if (base == (uintptr_t)NULL) {
-		/* No re-distributor base address. This interface cannot be
-		 * configured.
-		 */
-		panic();
-	}
+	base = gicv3_get_pcpu_rdist();
 
 	val = gicr_read_waker(base);
 	val |= WAKER_PS;
@@ -213,22 +250,13 @@ void arm_gic_cpuif_deactivate(void)
  ******************************************************************************/
 void arm_gic_pcpu_distif_setup(void)
 {
-	unsigned int index, irq_num;
-
 	assert(g_gicd_base);
-	gicd_write_igroupr(g_gicd_base, 0, ~0);
-
 	assert(g_irq_sec_ptr);
-	for (index = 0; index < g_num_irqs; index++) {
-		irq_num = g_irq_sec_ptr[index];
-		if (irq_num < MIN_SPI_ID) {
-			/* We have an SGI or a PPI */
-			gicd_clr_igroupr(g_gicd_base, irq_num);
-			gicd_set_ipriorityr(g_gicd_base, irq_num,
-				GIC_HIGHEST_SEC_PRIORITY);
-			gicd_set_isenabler(g_gicd_base, irq_num);
-		}
-	}
+
+	/* Configure the secure SGIs and PPIs and mark out the others */
+	gicd_setup_sec_irqs(g_gicd_base, MIN_SGI_ID, MIN_SPI_ID - MIN_SGI_ID,
+			    g_irq_sec_ptr, g_num_irqs,
+			    GIC_HIGHEST_SEC_PRIORITY, 0);
 }
 
 /*******************************************************************************
@@ -238,7 +266,7 @@ void arm_gic_pcpu_distif_setup(void)
  ******************************************************************************/
 static void arm_gic_distif_setup(void)
 {
-	unsigned int num_ints, ctlr, index, irq_num;
+	unsigned int num_ints, ctlr;
 
 	/* Disable the distributor before going further */
 	assert(g_gicd_base);
@@ -247,29 +275,20 @@ static void arm_gic_distif_setup(void)
 	gicd_write_ctlr(g_gicd_base, ctlr);
 
 	/*
-	 * Mark out non-secure interrupts. Calculate number of
-	 * IGROUPR registers to consider. Will be equal to the
-	 * number of IT_LINES
+	 * Configure the secure SPIs and mark out the non-secure ones. Calculate
+	 * the number of IGROUPR registers to consider. Will be equal to the
+	 * number of IT_LINES, the first one holding the SGIs and PPIs which are
+	 * configured by each cpu below.
 	 */
 	num_ints = gicd_read_typer(g_gicd_base) & IT_LINES_NO_MASK;
 	num_ints++;
-	for (index = 0; index < num_ints; index++)
-		gicd_write_igroupr(g_gicd_base, index << IGROUPR_SHIFT, ~0);
 
-	/* Configure secure interrupts now */
 	assert(g_irq_sec_ptr);
-	for (index = 0; index < g_num_irqs; index++) {
-		irq_num = g_irq_sec_ptr[index];
-		if (irq_num >= MIN_SPI_ID) {
-			/* We have an SPI */
-			gicd_clr_igroupr(g_gicd_base, irq_num);
-			gicd_set_ipriorityr(g_gicd_base, irq_num,
-				GIC_HIGHEST_SEC_PRIORITY);
-			gicd_set_itargetsr(g_gicd_base, irq_num,
-					platform_get_core_pos(read_mpidr()));
-			gicd_set_isenabler(g_gicd_base, irq_num);
-		}
-	}
+	gicd_setup_sec_irqs(g_gicd_base, MIN_SPI_ID,
+			    (num_ints << IGROUPR_SHIFT) - MIN_SPI_ID,
+			    g_irq_sec_ptr, g_num_irqs,
+			    GIC_HIGHEST_SEC_PRIORITY,
+			    platform_get_core_pos(read_mpidr()));
 	arm_gic_pcpu_distif_setup();
 
 	gicd_write_ctlr(g_gicd_base, ctlr | ENABLE_GRP0);
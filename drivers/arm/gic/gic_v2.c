@@ -292,6 +292,80 @@ void gicd_set_itargetsr(unsigned int base, unsigned int id, unsigned int iface)
 			     (1 << iface) << (byte_off << 3));
 }
 
+/*******************************************************************************
+ * This function makes the interrupts listed in 'irqs' with ids in the range of
+ * 'num_ids' ids starting at 'first_id' secure Group 0 interrupts with priority
+ * 'pri', routes those which are SPIs to the cpu interface 'iface' and enables
+ * them. The other interrupts in the range are made Group 1. The range must be
+ * aligned to 32 interrupts. The secure interrupts are first gathered in a
+ * bitmap, so that each GICD_IGROUPR and GICD_ISENABLER register in the range
+ * is written once and each GICD_IPRIORITYR and GICD_ITARGETSR register holding
+ * a secure interrupt is read and written once, instead of once per interrupt.
+ ******************************************************************************/
+void gicd_setup_sec_irqs(unsigned int base,
+			 unsigned int first_id,
+			 unsigned int num_ids,
+			 const unsigned int *irqs,
+			 unsigned int num_irqs,
+			 unsigned int pri,
+			 unsigned int iface)
+{
+	unsigned int sec_irqs[(GIC_SPURIOUS_INTERRUPT + 1) >> IGROUPR_SHIFT];
+	unsigned int index, id, n, sec, byte_mask, reg_val;
+
+	assert(((first_id | num_ids) & ((1 << IGROUPR_SHIFT) - 1)) == 0);
+	assert(first_id + num_ids <= GIC_SPURIOUS_INTERRUPT + 1);
+	assert(pri >= GIC_HIGHEST_SEC_PRIORITY &&
+	       pri <= GIC_LOWEST_SEC_PRIORITY);
+
+	for (id = first_id; id < first_id + num_ids; id += 1 << IGROUPR_SHIFT)
+		sec_irqs[id >> IGROUPR_SHIFT] = 0;
+
+	for (index = 0; index < num_irqs; index++) {
+		id = irqs[index];
+		if (id >= first_id && id < first_id + num_ids)
+			sec_irqs[id >> IGROUPR_SHIFT] |=
+				1 << (id & ((1 << IGROUPR_SHIFT) - 1));
+	}
+
+	for (id = first_id; id < first_id + num_ids; id += 1 << IGROUPR_SHIFT) {
+		sec = sec_irqs[id >> IGROUPR_SHIFT];
+
+		gicd_write_igroupr(base, id, ~sec);
+		if (sec == 0)
+			continue;
+
+		/*
+		 * Priorities and targets are held in a byte per interrupt.
+		 * Update the bytes of the secure interrupts in each register.
+		 */
+		for (index = 0; index < (1 << IGROUPR_SHIFT);
+		     index += 1 << IPRIORITYR_SHIFT) {
+			byte_mask = 0;
+			for (n = 0; n < (1 << IPRIORITYR_SHIFT); n++)
+				if (sec & (1 << (index + n)))
+					byte_mask |= GIC_PRI_MASK << (n << 3);
+			if (byte_mask == 0)
+				continue;
+
+			reg_val = gicd_read_ipriorityr(base, id + index);
+			reg_val &= ~byte_mask;
+			reg_val |= (pri * 0x01010101) & byte_mask;
+			gicd_write_ipriorityr(base, id + index, reg_val);
+
+			/* Only the targets of the SPIs are writable */
+			if (id + index < MIN_SPI_ID)
+				continue;
+
+			reg_val = gicd_read_itargetsr(base, id + index);
+			reg_val |= ((1 << iface) * 0x01010101) & byte_mask;
+			gicd_write_itargetsr(base, id + index, reg_val);
+		}
+
+		gicd_write_isenabler(base, id, sec);
+	}
+}
+
 /*******************************************************************************
  * This function allows the interrupt management framework to determine (through
  * the platform) which interrupt line (IRQ/FIQ) to use for an interrupt type to
@@ -32,11 +32,13 @@
 #include <debug.h>
 #include <gic_v3.h>
 
-uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
+/*******************************************************************************
+ * This function returns the affinity of the cpu with the given MPIDR in the
+ * format of the GICR_TYPER.Affinity_Value field
+ ******************************************************************************/
+static uint32_t gicv3_get_aff(uint64_t mpidr)
 {
-	uint32_t  cpu_aff, gicr_aff;
-	uint64_t  gicr_typer;
-	uintptr_t addr;
+	uint32_t cpu_aff;
 
 	/* Construct the affinity as used by GICv3. MPIDR and GIC affinity level
 	 * mask is the same.
@@ -50,6 +52,43 @@ uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
 	cpu_aff |= ((mpidr >> MPIDR_AFF3_SHIFT) & MPIDR_AFFLVL_MASK) <<
 			GICV3_AFF3_SHIFT;
 
+	return cpu_aff;
+}
+
+/*******************************************************************************
+ * This function returns the base address of the redistributor frame at the
+ * given position from 'gicr_base' if it belongs to the cpu with the given
+ * MPIDR, and NULL otherwise. It lets platforms whose redistributor frames are
+ * laid out in a known order find the frame of a cpu without scanning them.
+ * The caller must ensure that the frame exists.
+ ******************************************************************************/
+uintptr_t gicv3_get_rdist_at(uintptr_t gicr_base,
+			     unsigned int pos,
+			     uint64_t mpidr)
+{
+	uintptr_t addr;
+	uint32_t gicr_aff;
+
+	addr = gicr_base + ((uintptr_t)pos << GICR_PCPUBASE_SHIFT);
+	gicr_aff = (gicr_read_typer(addr) >> GICR_TYPER_AFF_SHIFT) &
+			GICR_TYPER_AFF_MASK;
+
+	return (gicr_aff == gicv3_get_aff(mpidr)) ? addr : (uintptr_t)NULL;
+}
+
+/*******************************************************************************
+ * This function scans the redistributor frames from 'gicr_base' until it finds
+ * the one belonging to the cpu with the given MPIDR and returns its base
+ * address, or NULL if there is none.
+ ******************************************************************************/
+uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
+{
+	uint32_t  cpu_aff, gicr_aff;
+	uint64_t  gicr_typer;
+	uintptr_t addr;
+
+	cpu_aff = gicv3_get_aff(mpidr);
+
 	addr = gicr_base;
 	do {
 		gicr_typer = gicr_read_typer(addr);
@@ -57,12 +96,8 @@ uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
 		gicr_aff = (gicr_typer >> GICR_TYPER_AFF_SHIFT) &
 				GICR_TYPER_AFF_MASK;
 		if (cpu_aff == gicr_aff) {
-			/* Disable this print for now as it appears every time
-			 * when using PSCI CPU_SUSPEND.
-			 * TODO: Print this only the first time for each CPU.
-			 * INFO("GICv3 - Found RDIST for MPIDR(0x%lx) at 0x%lx\n",
-			 *	mpidr, addr);
-			 */
+			INFO("GICv3 - Found RDIST for MPIDR(0x%lx) at 0x%lx\n",
+			     mpidr, addr);
 			return addr;
 		}
 
@@ -62,6 +62,8 @@ typedef struct {
 	 */
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/* Size of the image once decoded, for compressed payloads only */
+	size_t decoded_size;
 } file_state_t;
 
 static const plat_fip_name_uuid_t name_uuid[] = {
@@ -78,11 +80,36 @@ static const plat_fip_name_uuid_t name_uuid[] = {
 	{BL33_IMAGE_NAME, UUID_NON_TRUSTED_FIRMWARE_BL33},
 };
 
+#define NUM_FIP_IMAGES	(sizeof(name_uuid) / sizeof(name_uuid[0]))
+
 static const uuid_t uuid_null = {0};
-static file_state_t current_file = {0};
+
+/* Storage for a fixed maximum number of open files, definable by platform */
+static file_state_t file_pool[MAX_FIP_FILES];
+
+/* Simple way of tracking used storage - each entry is NULL or a pointer to a
+ * file state */
+static file_state_t *file_map[MAX_FIP_FILES];
+
+/* Track number of allocated file states */
+static unsigned int file_count;
+
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
+/* The backend is opened once by fip_dev_init() and kept open until
+ * fip_dev_close(). It is only accessed with positional reads, so no cursor
+ * needs to be tracked for it.
+ */
+static uintptr_t backend_handle;
+
+/* Cached Table of Contents, indexed in the same order as name_uuid[]. An
+ * entry with a zero offset_address is not present in the package.
+ */
+static fip_toc_entry_t toc_entries[NUM_FIP_IMAGES];
+
+static fip_backend_stats_t backend_stats;
+
 
 /* Firmware Image Package driver functions */
 static int fip_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
@@ -91,18 +118,17 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_read_at(io_entity_t *entity, size_t offset,
+			    uintptr_t buffer, size_t length,
+			    size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
+static int fip_file_address(io_entity_t *entity, uintptr_t *address);
+static int fip_file_encoding(io_entity_t *entity, io_encoding_t *encoding,
+			     size_t *decoded_size);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
 
 
-static inline int copy_uuid(uuid_t *dst, const uuid_t *src)
-{
-	memcpy(dst, src, sizeof(uuid_t));
-	return 0;
-}
-
-
 /* Return 0 for equal uuids. */
 static inline int compare_uuids(const uuid_t *uuid1, const uuid_t *uuid2)
 {
@@ -121,19 +147,103 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
-static int file_to_uuid(const char *filename, uuid_t *uuid)
+/* Return the index of a file in name_uuid[] or -EINVAL if unknown */
+static int file_to_index(const char *filename)
+{
+	int i;
+
+	for (i = 0; i < NUM_FIP_IMAGES; i++) {
+		if (strcmp(filename, name_uuid[i].name) == 0)
+			return i;
+	}
+	return -EINVAL;
+}
+
+
+/* Return the index of a UUID in name_uuid[] or -EINVAL if unknown */
+static int uuid_to_index(const uuid_t *uuid)
 {
 	int i;
-	int status = -EINVAL;
 
-	for (i = 0; i < (sizeof(name_uuid) / sizeof(name_uuid[0])); i++) {
-		if (strcmp(filename, name_uuid[i].name) == 0) {
-			copy_uuid(uuid, &name_uuid[i].uuid);
-			status = 0;
+	for (i = 0; i < NUM_FIP_IMAGES; i++) {
+		if (compare_uuids(uuid, &name_uuid[i].uuid) == 0)
+			return i;
+	}
+	return -EINVAL;
+}
+
+
+/* Locate a file state in the pool, specified by address */
+static int find_first_file(const file_state_t *fp, unsigned int *index_out)
+{
+	int result = IO_FAIL;
+	for (int index = 0; index < MAX_FIP_FILES; ++index) {
+		if (file_map[index] == fp) {
+			result = IO_SUCCESS;
+			*index_out = index;
 			break;
 		}
 	}
-	return status;
+	return result;
+}
+
+
+/* Allocate a file state from the pool and return a pointer to it */
+static int allocate_file(file_state_t **fp)
+{
+	int result = IO_FAIL;
+	assert(fp != NULL);
+
+	if (file_count < MAX_FIP_FILES) {
+		unsigned int index = 0;
+		result = find_first_file(NULL, &index);
+		assert(result == IO_SUCCESS);
+		*fp = file_map[index] = &file_pool[index];
+		++file_count;
+	} else
+		result = IO_RESOURCES_EXHAUSTED;
+
+	return result;
+}
+
+
+/* Release a file state back to the pool */
+static int free_file(const file_state_t *fp)
+{
+	int result = IO_FAIL;
+	unsigned int index = 0;
+	assert(fp != NULL);
+
+	result = find_first_file(fp, &index);
+	if (result == IO_SUCCESS) {
+		file_map[index] = NULL;
+		--file_count;
+	}
+
+	return result;
+}
+
+
+/* Read from the backend at an absolute offset in the package. Every open
+ * file shares the one backend handle, which is why a positional read is used
+ * rather than a seek and read pair.
+ */
+static int backend_read(size_t offset, uintptr_t buffer, size_t length,
+			size_t *length_read)
+{
+	int result;
+
+	assert(backend_handle != (uintptr_t)NULL);
+
+	result = io_read_at(backend_handle, offset, buffer, length,
+			    length_read);
+	backend_stats.read_count++;
+	if (result != IO_SUCCESS) {
+		WARN("Failed to read FIP (%i)\n", result);
+		return IO_FAIL;
+	}
+
+	return IO_SUCCESS;
 }
 
 
@@ -155,8 +265,11 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.seek = NULL,
 	.size = fip_file_len,
 	.read = fip_file_read,
+	.read_at = fip_file_read_at,
 	.write = NULL,
 	.close = fip_file_close,
+	.direct_address = fip_file_address,
+	.encoding = fip_file_encoding,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
 };
@@ -180,14 +293,20 @@ static int fip_dev_open(const uintptr_t dev_spec __attribute__((unused)),
 }
 
 
-/* Do some basic package checks. */
+/* Do some basic package checks and cache the Table of Contents. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result = IO_FAIL;
 	char *image_name = (char *)init_params;
-	uintptr_t backend_handle;
 	fip_toc_header_t header;
+	fip_toc_entry_t entry;
+	size_t toc_offset;
 	size_t bytes_read;
+	int index;
+
+	/* Nothing to do if the package has already been parsed */
+	if (backend_handle != (uintptr_t)NULL)
+		return IO_SUCCESS;
 
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_name, &backend_dev_handle,
@@ -204,31 +323,65 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 &backend_handle);
 	if (result != IO_SUCCESS) {
 		WARN("Failed to access image '%s' (%i)\n", image_name, result);
+		backend_handle = (uintptr_t)NULL;
 		result = IO_FAIL;
 		goto fip_dev_init_exit;
 	}
+	backend_stats.open_count++;
 
-	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
-			&bytes_read);
-	if (result == IO_SUCCESS) {
-		if (!is_valid_header(&header)) {
-			WARN("Firmware Image Package header check failed.\n");
-			result = IO_FAIL;
-		} else {
-			VERBOSE("FIP header looks OK.\n");
-		}
+	result = backend_read(0, (uintptr_t)&header, sizeof(header),
+			      &bytes_read);
+	if (result != IO_SUCCESS)
+		goto fip_dev_init_close;
+
+	if (!is_valid_header(&header)) {
+		WARN("Firmware Image Package header check failed.\n");
+		result = IO_FAIL;
+		goto fip_dev_init_close;
 	}
+	VERBOSE("FIP header looks OK.\n");
+
+	/* Walk the Table of Contents once and remember the known entries */
+	memset(toc_entries, 0, sizeof(toc_entries));
+	toc_offset = sizeof(header);
+	do {
+		result = backend_read(toc_offset, (uintptr_t)&entry,
+				      sizeof(entry), &bytes_read);
+		if (result != IO_SUCCESS)
+			goto fip_dev_init_close;
+		toc_offset += sizeof(entry);
+
+		index = uuid_to_index(&entry.uuid);
+		if (index >= 0)
+			toc_entries[index] = entry;
+	} while (compare_uuids(&entry.uuid, &uuid_null) != 0);
 
+	return IO_SUCCESS;
+
+ fip_dev_init_close:
 	io_close(backend_handle);
+	backend_handle = (uintptr_t)NULL;
 
  fip_dev_init_exit:
 	return result;
 }
 
-/* Close a connection to the FIP device */
+/* Close a connection to the FIP device. This is refused while any file in
+ * package is open, as all of them read through the backend.
+ */
 static int fip_dev_close(io_dev_info_t *dev_info)
 {
-	/* TODO: Consider tracking open files and cleaning them up here */
+	if (file_count != 0) {
+		WARN("fip_dev_close: %u file(s) still open\n", file_count);
+		return IO_FAIL;
+	}
+
+	/* Release the backend and forget the cached Table of Contents. */
+	if (backend_handle != (uintptr_t)NULL) {
+		io_close(backend_handle);
+		backend_handle = (uintptr_t)NULL;
+	}
+	memset(toc_entries, 0, sizeof(toc_entries));
 
 	/* Clear the backend. */
 	backend_dev_handle = (uintptr_t)NULL;
@@ -242,82 +395,66 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
-	int result = IO_FAIL;
-	uintptr_t backend_handle;
-	uuid_t file_uuid;
 	const io_file_spec_t *file_spec = (io_file_spec_t *)spec;
+	fip_lz4_header_t header;
 	size_t bytes_read;
-	int found_file = 0;
+	file_state_t *fp;
+	int index;
+	int result;
 
 	assert(file_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return IO_RESOURCES_EXHAUSTED;
+	if (backend_handle == (uintptr_t)NULL) {
+		WARN("fip_file_open: FIP device not initialised\n");
+		return IO_FAIL;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != IO_SUCCESS) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = IO_FAIL;
-		goto fip_file_open_exit;
+	/* Look the file up in the cached Table of Contents */
+	index = file_to_index(file_spec->path);
+	if ((index < 0) || (toc_entries[index].offset_address == 0)) {
+		/* Did not find the file in the FIP. */
+		return IO_FAIL;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
+	/* Each open file needs its own state to track the file cursor */
+	result = allocate_file(&fp);
 	if (result != IO_SUCCESS) {
-		WARN("fip_file_open: failed to seek\n");
-		result = IO_FAIL;
-		goto fip_file_open_close;
+		WARN("fip_file_open: too many open files\n");
+		return result;
 	}
 
-	file_to_uuid(file_spec->path, &file_uuid);
+	/* All fine. Update entity info with file state and return. Set the
+	 * file position to 0. The 'fp->entry' holds the base and size of
+	 * the file.
+	 */
+	fp->entry = toc_entries[index];
+	fp->file_pos = 0;
+	fp->decoded_size = 0;
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == IO_SUCCESS) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &file_uuid) == 0) {
-				found_file = 1;
-				break;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
-		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
+	/* A compressed payload starts with a header giving its decoded size.
+	 * Skip it so that reads return the compressed data only.
+	 */
+	if (fp->entry.flags & TOC_ENTRY_FLAG_LZ4) {
 		result = IO_FAIL;
+		if (fp->entry.size >= sizeof(header))
+			result = backend_read(fp->entry.offset_address,
+					      (uintptr_t)&header,
+					      sizeof(header), &bytes_read);
+		if ((result != IO_SUCCESS) || (bytes_read != sizeof(header)) ||
+		    (header.name != LZ4_HEADER_NAME)) {
+			WARN("fip_file_open: bad compressed payload header\n");
+			(void)free_file(fp);
+			return IO_FAIL;
+		}
+		fp->entry.offset_address += sizeof(header);
+		fp->entry.size -= sizeof(header);
+		fp->decoded_size = header.decoded_size;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	entity->info = (uintptr_t)fp;
 
- fip_file_open_exit:
-	return result;
+	return IO_SUCCESS;
 }
 
 
@@ -333,71 +470,78 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 }
 
 
-/* Read data from a file in package */
-static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
-			  size_t *length_read)
+/* Read data from an offset in a file in package. The file cursor is left
+ * untouched and the read is clipped to the end of the file.
+ */
+static int fip_file_read_at(io_entity_t *entity, size_t offset,
+			    uintptr_t buffer, size_t length,
+			    size_t *length_read)
 {
 	int result = IO_FAIL;
 	file_state_t *fp;
-	size_t file_offset;
-	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != IO_SUCCESS) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = IO_FAIL;
-		goto fip_file_read_exit;
-	}
-
 	fp = (file_state_t *)entity->info;
 
-	/* Seek to the position in the FIP where the payload lives */
-	file_offset = fp->entry.offset_address + fp->file_pos;
-	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
-	if (result != IO_SUCCESS) {
-		WARN("fip_file_read: failed to seek\n");
-		result = IO_FAIL;
-		goto fip_file_read_close;
+	if (offset > fp->entry.size) {
+		WARN("Read beyond end of payload\n");
+		return IO_FAIL;
 	}
+	if (length > fp->entry.size - offset)
+		length = fp->entry.size - offset;
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	/* Read from the position in the FIP where the payload lives */
+	result = backend_read(fp->entry.offset_address + offset, buffer,
+			      length, length_read);
 	if (result != IO_SUCCESS) {
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
-		result = IO_FAIL;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		return IO_FAIL;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	return IO_SUCCESS;
+}
 
- fip_file_read_exit:
-	return result;
+
+/* Read data from a file in package */
+static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+			  size_t *length_read)
+{
+	int result = IO_FAIL;
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	result = fip_file_read_at(entity, fp->file_pos, buffer, length,
+				  length_read);
+	if (result != IO_SUCCESS)
+		return result;
+
+	/* Advance the file position for incremental reads */
+	fp->file_pos += *length_read;
+
+	return IO_SUCCESS;
 }
 
 
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
+	assert(entity != NULL);
+
+	/* Return the file state to the pool.
 	 * If we had malloc() we would free() here.
 	 */
-	if (current_file.entry.offset_address != 0) {
-		memset(&current_file, 0, sizeof(current_file));
-	}
+	if (entity->info != (uintptr_t)NULL)
+		(void)free_file((file_state_t *)entity->info);
 
 	/* Clear the Entity info. */
 	entity->info = 0;
@@ -405,8 +549,58 @@ static int fip_file_close(io_entity_t *entity)
 	return IO_SUCCESS;
 }
 
+
+/* Return the address of a file in package if the backend is memory-mapped */
+static int fip_file_address(io_entity_t *entity, uintptr_t *address)
+{
+	int result;
+	uintptr_t backend_address;
+
+	assert(entity != NULL);
+	assert(address != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	result = io_get_direct_address(backend_handle, &backend_address);
+	if (result == IO_SUCCESS) {
+		*address = backend_address +
+			((file_state_t *)entity->info)->entry.offset_address;
+	}
+
+	return result;
+}
+
+/* Return the encoding of a file in package */
+static int fip_file_encoding(io_entity_t *entity, io_encoding_t *encoding,
+			     size_t *decoded_size)
+{
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	if (fp->entry.flags & TOC_ENTRY_FLAG_LZ4) {
+		*encoding = IO_ENCODING_LZ4;
+		*decoded_size = fp->decoded_size;
+	} else {
+		*encoding = IO_ENCODING_NONE;
+		*decoded_size = fp->entry.size;
+	}
+
+	return IO_SUCCESS;
+}
+
+
 /* Exported functions */
 
+/* Report the number of backend accesses made by the FIP driver */
+void fip_get_backend_stats(fip_backend_stats_t *stats)
+{
+	assert(stats != NULL);
+	*stats = backend_stats;
+}
+
 /* Register the Firmware Image Package driver with the IO abstraction */
 int register_io_dev_fip(const io_dev_connector_t **dev_con)
 {
@@ -44,6 +44,7 @@ typedef struct {
 	 */
 	int		in_use;
 	uintptr_t	base;
+	size_t		size;
 	size_t		file_pos;
 } file_state_t;
 
@@ -63,9 +64,13 @@ static int memmap_block_seek(io_entity_t *entity, int mode,
 			     ssize_t offset);
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
+static int memmap_block_read_at(io_entity_t *entity, size_t offset,
+				uintptr_t buffer, size_t length,
+				size_t *length_read);
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
+static int memmap_block_address(io_entity_t *entity, uintptr_t *address);
 static int memmap_dev_close(io_dev_info_t *dev_info);
 
 
@@ -80,8 +85,11 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.seek = memmap_block_seek,
 	.size = NULL,
 	.read = memmap_block_read,
+	.read_at = memmap_block_read_at,
 	.write = memmap_block_write,
 	.close = memmap_block_close,
+	.direct_address = memmap_block_address,
+	.encoding = NULL,
 	.dev_init = NULL,
 	.dev_close = memmap_dev_close,
 };
@@ -133,6 +141,7 @@ static int memmap_block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 
 		current_file.in_use = 1;
 		current_file.base = block_spec->offset;
+		current_file.size = block_spec->length;
 		/* File cursor offset for seek and incremental reads etc. */
 		current_file.file_pos = 0;
 		entity->info = (uintptr_t)&current_file;
@@ -188,6 +197,36 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 }
 
 
+/* Read data from an offset in a file on the memmap device. The file cursor
+ * is left untouched and the read is clipped to the end of the block.
+ */
+static int memmap_block_read_at(io_entity_t *entity, size_t offset,
+				uintptr_t buffer, size_t length,
+				size_t *length_read)
+{
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(buffer != (uintptr_t)NULL);
+	assert(length_read != NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	if (offset > fp->size) {
+		WARN("Read beyond end of memmap block\n");
+		return IO_FAIL;
+	}
+	if (length > fp->size - offset)
+		length = fp->size - offset;
+
+	memcpy((void *)buffer, (void *)(fp->base + offset), length);
+
+	*length_read = length;
+
+	return IO_SUCCESS;
+}
+
+
 /* Write data to a file on the memmap device */
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written)
@@ -225,6 +264,18 @@ static int memmap_block_close(io_entity_t *entity)
 }
 
 
+/* Return the address of the start of a block on the memmap device */
+static int memmap_block_address(io_entity_t *entity, uintptr_t *address)
+{
+	assert(entity != NULL);
+	assert(address != NULL);
+
+	*address = ((file_state_t *)entity->info)->base;
+
+	return IO_SUCCESS;
+}
+
+
 /* Exported functions */
 
 /* Register the memmap driver with the IO abstraction */
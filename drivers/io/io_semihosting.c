@@ -51,6 +51,8 @@ static int sh_file_seek(io_entity_t *entity, int mode, ssize_t offset);
 static int sh_file_len(io_entity_t *entity, size_t *length);
 static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		size_t *length_read);
+static int sh_file_read_at(io_entity_t *entity, size_t offset,
+		uintptr_t buffer, size_t length, size_t *length_read);
 static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written);
 static int sh_file_close(io_entity_t *entity);
@@ -66,8 +68,11 @@ static const io_dev_funcs_t sh_dev_funcs = {
 	.seek = sh_file_seek,
 	.size = sh_file_len,
 	.read = sh_file_read,
+	.read_at = sh_file_read_at,
 	.write = sh_file_write,
 	.close = sh_file_close,
+	.direct_address = NULL,
+	.encoding = NULL,
 	.dev_init = NULL,	/* NOP */
 	.dev_close = NULL,	/* NOP */
 };
@@ -179,6 +184,22 @@ static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/* Read data from an offset in a file on the semi-hosting device. The host
+ * has no positional read, so the file is repositioned before the read.
+ */
+static int sh_file_read_at(io_entity_t *entity, size_t offset,
+		uintptr_t buffer, size_t length, size_t *length_read)
+{
+	int result = IO_FAIL;
+
+	result = sh_file_seek(entity, IO_SEEK_SET, (ssize_t)offset);
+	if (result == IO_SUCCESS)
+		result = sh_file_read(entity, buffer, length, length_read);
+
+	return result;
+}
+
+
 /* Write data to a file on the semi-hosting device */
 static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written)
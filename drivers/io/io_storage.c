@@ -327,6 +327,34 @@ int io_read(uintptr_t handle,
 }
 
 
+/* Read data from an absolute offset in an IO entity */
+int io_read_at(uintptr_t handle,
+		size_t offset,
+		uintptr_t buffer,
+		size_t length,
+		size_t *length_read)
+{
+	int result = IO_FAIL;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->read_at != NULL) {
+		result = dev->funcs->read_at(entity, offset, buffer, length,
+					     length_read);
+	} else {
+		/* Fall back to positioning the cursor before the read */
+		result = io_seek(handle, IO_SEEK_SET, (ssize_t)offset);
+		if (result == IO_SUCCESS)
+			result = io_read(handle, buffer, length, length_read);
+	}
+
+	return result;
+}
+
+
 /* Write data to an IO entity */
 int io_write(uintptr_t handle,
 		const uintptr_t buffer,
@@ -371,3 +399,43 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+/* Obtain the memory-mapped address of the start of an IO entity */
+int io_get_direct_address(uintptr_t handle, uintptr_t *address)
+{
+	int result = IO_FAIL;
+	assert(is_valid_entity(handle) && (address != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->direct_address != NULL)
+		result = dev->funcs->direct_address(entity, address);
+	else
+		result = IO_NOT_SUPPORTED;
+
+	return result;
+}
+
+
+/* Determine the encoding of an IO entity */
+int io_get_encoding(uintptr_t handle, io_encoding_t *encoding,
+		size_t *decoded_size)
+{
+	int result = IO_FAIL;
+	assert(is_valid_entity(handle) && (encoding != NULL) &&
+	       (decoded_size != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->encoding != NULL)
+		result = dev->funcs->encoding(entity, encoding, decoded_size);
+	else
+		result = IO_NOT_SUPPORTED;
+
+	return result;
+}
@@ -52,6 +52,7 @@ static inline void cm_set_context(void *context, uint32_t security_state);
 void cm_init_context(uint64_t mpidr, const struct entry_point_info *ep);
 void cm_prepare_el3_exit(uint32_t security_state);
 void cm_el1_sysregs_context_save(uint32_t security_state);
+void cm_el1_sysregs_context_save_volatile(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
 void cm_set_elr_el3(uint32_t security_state, uint64_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
@@ -61,6 +62,10 @@ void cm_write_scr_el3_bit(uint32_t security_state,
 			  uint32_t value);
 void cm_set_next_eret_context(uint32_t security_state);
 uint32_t cm_get_scr_el3(uint32_t security_state);
+#if CTX_LAZY_FPREGS
+void cm_fpregs_lazy_switch(void *context);
+void cm_fpregs_flush(void);
+#endif
 
 /* Inline definitions */
 
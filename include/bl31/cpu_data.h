@@ -32,8 +32,14 @@
 #define __CPU_DATA_H__
 
 /* Offsets for the cpu_data structure */
-#define CPU_DATA_CRASH_BUF_OFFSET	0x20
-#if CRASH_REPORTING
+#define CPU_DATA_CRASH_BUF_OFFSET	0x40
+#if SMC_STATS && (PSCI_STATS || CTX_LAZY_FPREGS)
+#define CPU_DATA_LOG2SIZE		10
+#elif SMC_STATS
+#define CPU_DATA_LOG2SIZE		9
+#elif PSCI_STATS || (CRASH_REPORTING && CTX_LAZY_FPREGS)
+#define CPU_DATA_LOG2SIZE		8
+#elif CRASH_REPORTING || CTX_LAZY_FPREGS
 #define CPU_DATA_LOG2SIZE		7
 #else
 #define CPU_DATA_LOG2SIZE		6
@@ -45,8 +51,10 @@
 #ifndef __ASSEMBLY__
 
 #include <arch_helpers.h>
+#include <cassert.h>
 #include <platform_def.h>
 #include <psci.h>
+#include <smc_stats.h>
 #include <stdint.h>
 
 /*******************************************************************************
@@ -56,9 +64,14 @@
 /*******************************************************************************
  * Cache of frequently used per-cpu data:
  *   Pointers to non-secure and secure security state contexts
+ *   PSCI state and the affinity map nodes of the cpu
  *   Address of the crash stack
- * It is aligned to the cache line boundary to allow efficient concurrent
- * manipulation of these pointers on different cpus
+ *   SMC statistics, if SMC_STATS is enabled
+ *   PSCI power state statistics, if PSCI_STATS is enabled
+ *   Context owning the FP/SIMD registers, if CTX_LAZY_FPREGS is enabled
+ * It is aligned to its own size, which is at least a cache line, to allow
+ * efficient concurrent manipulation of these pointers on different cpus and
+ * indexing of the per-cpu data array with a shift
  *
  * TODO: Add other commonly used variables to this (tf_issues#90)
  *
@@ -73,7 +86,16 @@ typedef struct cpu_data {
 #if CRASH_REPORTING
 	uint64_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3];
 #endif
-} __aligned(CACHE_WRITEBACK_GRANULE) cpu_data_t;
+#if SMC_STATS
+	smc_stats_t smc_stats;
+#endif
+#if PSCI_STATS
+	psci_stats_t psci_stats;
+#endif
+#if CTX_LAZY_FPREGS
+	void *fpregs_owner;
+#endif
+} __aligned(1 << CPU_DATA_LOG2SIZE) cpu_data_t;
 
 #if CRASH_REPORTING
 /* verify assembler offsets match data structures */
@@ -85,6 +107,9 @@ CASSERT(CPU_DATA_CRASH_BUF_OFFSET == __builtin_offsetof
 CASSERT((1 << CPU_DATA_LOG2SIZE) == sizeof(cpu_data_t),
 	assert_cpu_data_log2size_mismatch);
 
+CASSERT((1 << CPU_DATA_LOG2SIZE) >= CACHE_WRITEBACK_GRANULE,
+	assert_cpu_data_smaller_than_cache_line);
+
 CASSERT(CPU_DATA_CPU_OPS_PTR == __builtin_offsetof
 		(cpu_data_t, cpu_ops_ptr),
 		assert_cpu_data_cpu_ops_ptr_offset_mismatch);
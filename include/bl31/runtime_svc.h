@@ -120,6 +120,16 @@
  */
 #define MAX_RT_SVCS		128
 
+/*
+ * Constants to allow the assembler access a leaf SMC handler descriptor. At most
+ * MAX_RT_SVC_LEAVES leaf handlers can be registered.
+ */
+#define RT_SVC_LEAF_SIZE_LOG2	4
+#define SIZEOF_RT_SVC_LEAF_DESC	(1 << RT_SVC_LEAF_SIZE_LOG2)
+#define RT_SVC_LEAF_DESC_FID	0
+#define RT_SVC_LEAF_DESC_HANDLE	8
+#define MAX_RT_SVC_LEAVES	8
+
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
@@ -212,6 +222,36 @@ typedef struct rt_svc_desc {
 			_setup, \
 			_smch }
 
+/*
+ * Prototype for a leaf SMC handler function. Leaf handlers serve a single fast
+ * SMC function ID which returns one value in x0. They are called directly from
+ * the exception vector with only the caller saved registers preserved, so they
+ * must not access the cpu context, cause a world switch or fail to return.
+ * 'flags' indicates the security state of the caller as for a runtime service
+ * SMC handler.
+ */
+typedef uint64_t (*rt_svc_leaf_handle_t)(uint32_t smc_fid,
+					 uint64_t x1,
+					 uint64_t x2,
+					 uint64_t x3,
+					 uint64_t flags);
+typedef struct rt_svc_leaf_desc {
+	uint32_t smc_fid;
+	rt_svc_leaf_handle_t handle;
+} rt_svc_leaf_desc_t;
+
+/*
+ * Convenience macro to declare a leaf SMC handler, to be used only when
+ * SMC_LEAF_HANDLERS is enabled. The handler is only used if the runtime service
+ * owning the function ID has been successfully initialised; otherwise the SMC
+ * is dispatched as usual.
+ */
+#define DECLARE_RT_SVC_LEAF(_name, _fid, _smch) \
+	static const rt_svc_leaf_desc_t __svc_leaf_desc_ ## _name \
+		__attribute__ ((section("rt_svc_leaf_descs"), used)) = { \
+			_fid, \
+			_smch }
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -220,6 +260,7 @@ typedef struct rt_svc_desc {
  *    routine at the same offset.
  * 3. ensure that the assembler and the compiler see the handler
  *    routine at the same offset.
+ * The same applies to the 'rt_svc_leaf_desc' structure and its function id.
  */
 CASSERT((sizeof(rt_svc_desc_t) == SIZEOF_RT_SVC_DESC), \
 	assert_sizeof_rt_svc_desc_mismatch);
@@ -227,6 +268,13 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 	assert_rt_svc_desc_init_offset_mismatch);
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
+CASSERT((sizeof(rt_svc_leaf_desc_t) == SIZEOF_RT_SVC_LEAF_DESC), \
+	assert_sizeof_rt_svc_leaf_desc_mismatch);
+CASSERT(RT_SVC_LEAF_DESC_FID == __builtin_offsetof(rt_svc_leaf_desc_t, smc_fid), \
+	assert_rt_svc_leaf_desc_fid_offset_mismatch);
+CASSERT(RT_SVC_LEAF_DESC_HANDLE == \
+	__builtin_offsetof(rt_svc_leaf_desc_t, handle), \
+	assert_rt_svc_leaf_desc_handle_offset_mismatch);
 
 
 /*
@@ -267,6 +315,8 @@ CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 void runtime_svc_init(void);
 extern uint64_t __RT_SVC_DESCS_START__;
 extern uint64_t __RT_SVC_DESCS_END__;
+extern uint64_t __RT_SVC_LEAF_DESCS_START__;
+extern uint64_t __RT_SVC_LEAF_DESCS_END__;
 void init_crash_reporting(void);
 
 #endif /*__ASSEMBLY__*/
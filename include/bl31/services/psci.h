@@ -51,10 +51,24 @@
 #define PSCI_SYSTEM_OFF			0x84000008
 #define PSCI_SYSTEM_RESET		0x84000009
 
+/*
+ * The PSCI 1.0 statistics calls, with the function IDs and results defined by
+ * PSCI 1.0. They are served with PSCI_STATS=1 although PSCI_VERSION reports
+ * 0.2, as the rest of PSCI 1.0 is not implemented.
+ */
+#define PSCI_STAT_RESIDENCY_AARCH32	0x84000010
+#define PSCI_STAT_RESIDENCY_AARCH64	0xc4000010
+#define PSCI_STAT_COUNT_AARCH32		0x84000011
+#define PSCI_STAT_COUNT_AARCH64		0xc4000011
+
 /*
  * Number of PSCI calls (above) implemented
  */
+#if PSCI_STATS
+#define PSCI_NUM_CALLS			19
+#else
 #define PSCI_NUM_CALLS			15
+#endif
 
 /*******************************************************************************
  * PSCI Migrate and friends
@@ -129,25 +143,68 @@
 
 #ifndef __ASSEMBLY__
 
+#include <arch.h>
 #include <stdint.h>
 
+struct aff_map_node;
+
 /*******************************************************************************
  * Structure used to store per-cpu information relevant to the PSCI service.
  * It is populated in the per-cpu data array. In return we get a guarantee that
  * this information will not reside on a cache line shared with another cpu.
+ * 'aff_map_nodes' holds the nodes of the affinity instances which contain the
+ * cpu at each affinity level. It is populated once by psci_setup().
+ * 'next_wakeup' holds the system counter value at which the timers of the cpu
+ * will wake it up from its last power down state, if the platform describes
+ * its idle states.
  ******************************************************************************/
 typedef struct psci_cpu_data {
 	uint32_t power_state;
 	uint32_t max_phys_off_afflvl;	/* Highest affinity level in physically
 					   powered off state */
+	struct aff_map_node *aff_map_nodes[MPIDR_MAX_AFFLVL + 1];
+	uint64_t next_wakeup;
 } psci_cpu_data_t;
 
+/*******************************************************************************
+ * Structures used to account, on each cpu, for the power down states entered
+ * with CPU_SUSPEND at each affinity level. Times are in ticks of the system
+ * counter. The residency covers the time from the entry into the state to the
+ * cpu powering up and the exit latency the time taken by the last power up
+ * sequence in BL3-1. Only the cpu which owns the structure updates it.
+ ******************************************************************************/
+typedef struct psci_stat {
+	uint64_t count;
+	uint64_t residency;
+	uint64_t exit_latency;
+} psci_stat_t;
+
+typedef struct psci_stats {
+	uint64_t pwrdn_timestamp;
+	psci_stat_t afflvl[MPIDR_MAX_AFFLVL + 1];
+} psci_stats_t;
+
+/*******************************************************************************
+ * Structure used by platform specific code to describe one of its idle states
+ * i.e. the 'power_state' parameter of CPU_SUSPEND which enters it, its entry
+ * and exit latencies and the minimum residency for which entering it is worth
+ * it, all in microseconds.
+ ******************************************************************************/
+typedef struct plat_idle_state {
+	unsigned int power_state;
+	unsigned int entry_latency;
+	unsigned int exit_latency;
+	unsigned int target_residency;
+} plat_idle_state_t;
+
 /*******************************************************************************
  * Structure populated by platform specific code to export routines which
  * perform common low level pm functions
  ******************************************************************************/
 typedef struct plat_pm_ops {
 	int (*affinst_standby)(unsigned int);
+	int (*affinst_is_retention)(unsigned int);
+	unsigned int (*get_idle_states)(const plat_idle_state_t **);
 	int (*affinst_on)(unsigned long,
 			  unsigned long,
 			  unsigned long,
@@ -196,6 +253,11 @@ unsigned long psci_migrate_info_up_cpu(void);
 int psci_cpu_on(unsigned long,
 		unsigned long,
 		unsigned long);
+int psci_cpu_on_batch(unsigned long cluster_mpidr,
+		      uint64_t aff0_map,
+		      unsigned long entrypoint,
+		      unsigned long context_id,
+		      uint64_t *on_map);
 void __dead2 psci_power_down_wfi(void);
 void psci_aff_on_finish_entry(void);
 void psci_aff_suspend_finish_entry(void);
@@ -204,6 +266,14 @@ int psci_get_suspend_stateid_by_mpidr(unsigned long);
 int psci_get_suspend_stateid(void);
 int psci_get_suspend_afflvl(void);
 uint32_t psci_get_max_phys_off_afflvl(void);
+uint64_t psci_stat_residency(unsigned long target_cpu,
+			     unsigned int power_state);
+uint64_t psci_stat_count(unsigned long target_cpu, unsigned int power_state);
+uint64_t psci_stat_exit_latency(unsigned long target_cpu,
+				unsigned int power_state);
+int psci_cpu_suspend_latency(unsigned int latency,
+			     unsigned long entrypoint,
+			     unsigned long context_id);
 
 uint64_t psci_smc_handler(uint32_t smc_fid,
 			  uint64_t x1,
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIP_SVC_H__
+#define __SIP_SVC_H__
+
+/* SMC function IDs for SiP Service queries */
+
+#define SIP_SVC_CALL_COUNT		0x8200ff00
+#define SIP_SVC_UID			0x8200ff01
+/*					0x8200ff02 is reserved */
+#define SIP_SVC_VERSION			0x8200ff03
+
+/* SiP Service Calls version numbers */
+#define SIP_SVC_VERSION_MAJOR		0x0
+#define SIP_SVC_VERSION_MINOR		0x4
+
+/*
+ * SMC statistics calls (SMC64). They return SMC_UNK unless BL3-1 is built with
+ * SMC_STATS=1.
+ *
+ * SIP_SVC_SMC_STATS_GET
+ *	x1: linear index of the CPU, x2: slot index
+ *	Returns x0: function ID (SMC_UNK if the arguments are out of range,
+ *	SMC_STATS_FID_OTHER for the last slot once it is in use),
+ *	x1: call count, x2: total ticks, x3: max ticks << 32 | min ticks
+ *
+ * SIP_SVC_SMC_STATS_GET_OEN
+ *	x1: linear index of the CPU, x2: call type << 6 | OEN
+ *	Returns x0: 0 (SMC_UNK if the arguments are out of range), x1-x3 as above
+ *
+ * SIP_SVC_SMC_STATS_RESET
+ *	x1: linear index of the CPU
+ *	Returns x0: 0 (SMC_UNK if the argument is out of range)
+ */
+#define SIP_SVC_SMC_STATS_GET		0xc2000000
+#define SIP_SVC_SMC_STATS_GET_OEN	0xc2000001
+#define SIP_SVC_SMC_STATS_RESET		0xc2000002
+
+/*
+ * Vendor specific extension of PSCI CPU_SUSPEND (SMC64), for the normal world.
+ * The firmware selects the deepest idle state described by the platform which
+ * fits the wake up latency tolerated by the caller.
+ *
+ * SIP_SVC_CPU_SUSPEND_LATENCY
+ *	x1: tolerated latency in microseconds, x2: entrypoint, x3: context id
+ *	Returns x0: PSCI error code, as CPU_SUSPEND
+ */
+#define SIP_SVC_CPU_SUSPEND_LATENCY	0xc2000003
+
+/*
+ * Vendor specific extension of PSCI CPU_ON (SMC64), for the normal world. It
+ * turns on several CPUs of a cluster with the same entrypoint and context id,
+ * taking the locks of the cluster only once.
+ *
+ * SIP_SVC_CPU_ON_BATCH
+ *	x1: MPIDR of the cluster (affinity level 0 is 0), x2: bitmap of the
+ *	affinity level 0 values of the CPUs, x3: entrypoint, x4: context id
+ *	Returns x0: PSCI error code (the first error for any CPU),
+ *	x1: bitmap of the CPUs which are turned on
+ */
+#define SIP_SVC_CPU_ON_BATCH		0xc2000004
+
+/*
+ * Exit latency of a power down state, which PSCI_STAT_RESIDENCY does not
+ * report (SMC64). It returns SMC_UNK unless BL3-1 is built with PSCI_STATS=1.
+ *
+ * SIP_SVC_PSCI_STAT_EXIT_LATENCY
+ *	x1: MPIDR of the CPU, x2: power_state parameter of CPU_SUSPEND
+ *	Returns x0: time in microseconds taken by the last power up sequence of
+ *	the CPU from that state in BL3-1 (0 if the arguments are invalid)
+ */
+#define SIP_SVC_PSCI_STAT_EXIT_LATENCY	0xc2000005
+
+/* Number of SiP Service Calls, excluding the queries above */
+#if SMC_STATS
+#define SIP_SVC_SMC_STATS_NUM_CALLS	3
+#else
+#define SIP_SVC_SMC_STATS_NUM_CALLS	0
+#endif
+
+#if PSCI_STATS
+#define SIP_SVC_PSCI_STATS_NUM_CALLS	1
+#else
+#define SIP_SVC_PSCI_STATS_NUM_CALLS	0
+#endif
+
+#define SIP_SVC_NUM_CALLS		(2 + SIP_SVC_SMC_STATS_NUM_CALLS + \
+					 SIP_SVC_PSCI_STATS_NUM_CALLS)
+
+#endif /* __SIP_SVC_H__ */
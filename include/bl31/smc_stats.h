@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMC_STATS_H__
+#define __SMC_STATS_H__
+
+/*
+ * Number of function IDs whose calls are accounted separately on each CPU. The
+ * last slot is shared by all the function IDs that do not fit in the others,
+ * and reports SMC_STATS_FID_OTHER as its function ID. Bits [23:16] of a valid
+ * function ID are zero, so this value cannot be confused with an SMC or with
+ * SMC_UNK.
+ */
+#define SMC_STATS_MAX_FIDS	16
+#define SMC_STATS_FID_OTHER	0x00ff0000
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Accounting of the calls to one SMC function ID on one CPU. Times are in
+ * ticks of the system counter and cover the time spent in the runtime service
+ * handler, from its invocation by the SMC dispatcher until it returns. Calls
+ * served by leaf SMC handlers (SMC_LEAF_HANDLERS) never reach the dispatcher
+ * and are not accounted for.
+ ******************************************************************************/
+typedef struct smc_stats_entry {
+	uint32_t smc_fid;
+	uint32_t count;
+	uint64_t total_ticks;
+	uint32_t min_ticks;
+	uint32_t max_ticks;
+} smc_stats_entry_t;
+
+typedef struct smc_stats {
+	smc_stats_entry_t entries[SMC_STATS_MAX_FIDS];
+} smc_stats_t;
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void smc_stats_record(uint32_t smc_fid, uint64_t start_ticks);
+const smc_stats_entry_t *smc_stats_get_entry(uint32_t cpu_idx,
+					     uint32_t entry_idx);
+int smc_stats_get_oen(uint32_t cpu_idx, uint32_t oen,
+		      smc_stats_entry_t *result);
+void smc_stats_reset(uint32_t cpu_idx);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SMC_STATS_H__ */
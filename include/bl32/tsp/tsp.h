@@ -52,8 +52,14 @@
 #define TSP_HANDLED_S_EL1_FIQ		0xf2000006
 #define TSP_EL3_FIQ			0xf2000007
 
-/* SMC function ID that TSP uses to request service from secure monitor */
+/*
+ * SMC function IDs that TSP uses to request service from secure monitor.
+ * TSP_SYSREGS_CHANGED reports that the TSP has changed S-EL1 system registers
+ * outside the subset saved on each exit when TSPD_PARTIAL_SYSREGS_SAVE=1, so
+ * that the TSPD saves them all when it next exits. It takes no arguments.
+ */
 #define TSP_GET_ARGS		0xf2001000
+#define TSP_SYSREGS_CHANGED	0xf2001001
 
 /*
  * Identifiers for various TSP services. Corresponding function IDs (whether
@@ -64,6 +70,7 @@
 #define TSP_MUL		0x2002
 #define TSP_DIV		0x2003
 #define TSP_HANDLE_FIQ_AND_RETURN	0x2004
+#define TSP_NULL	0x2005
 
 /*
  * Generate function IDs for TSP services to be used in SMC calls, by
@@ -75,6 +82,12 @@
 /* SMC function ID to request a previously preempted std smc */
 #define TSP_FID_RESUME		TSP_STD_FID(0x3000)
 
+/*
+ * Maximum number of system counter ticks a standard TSP_NULL call waits for
+ * before returning. Longer delays requested in x1 are truncated to this value.
+ */
+#define TSP_NULL_MAX_DELAY	0x1000000
+
 /*
  * Identify a TSP service from function ID filtering the last 16 bits from the
  * SMC function ID
@@ -85,7 +98,7 @@
  * Total number of function IDs implemented for services offered to NS clients.
  * The function IDs are defined above
  */
-#define TSP_NUM_FID		0x4
+#define TSP_NUM_FID		0x5
 
 /* TSP implementation version numbers */
 #define TSP_VERSION_MAJOR	0x0 /* Major version */
@@ -95,6 +95,9 @@
 #include <cassert.h>
 #include <stdint.h>
 #include <stddef.h>
+#if MEASURED_BOOT
+#include <sha256.h>
+#endif
 
 /*******************************************************************************
  * Structure used for telling the next BL how much of a particular type of
@@ -149,12 +152,16 @@ typedef struct entry_point_info {
  * can be used by the firmware to manage available trusted RAM.
  * More advanced firmware image formats can provide additional
  * information that enables optimization or greater flexibility in the
- * common firmware code
+ * common firmware code. When MEASURED_BOOT is enabled, it also records the
+ * SHA-256 digest of the image as loaded by load_image().
  *****************************************************************************/
 typedef struct image_info {
 	param_header_t h;
 	uintptr_t image_base;   /* physical address of base of image */
 	uint32_t image_size;    /* bytes read from image file */
+#if MEASURED_BOOT
+	uint8_t digest[SHA256_DIGEST_SIZE];
+#endif
 } image_info_t;
 
 /*******************************************************************************
@@ -169,8 +176,15 @@ typedef struct image_info {
  *
  * BL3-1 image information is mandatory if this structure is used. If either of
  * the optional BL3-2 and BL3-3 image information is not provided, this is
- * indicated by the respective image_info pointers being zero.
+ * indicated by the respective image_info pointers being zero. The same applies
+ * to the table of boot timestamps recorded when BOOT_TIMESTAMPS is enabled.
+ *
+ * When MEASURED_BOOT is enabled, the image_info structures carry the digests
+ * of the BL3-1, BL3-2 and BL3-3 images, so the BL3-1 platform code should copy
+ * them before the memory holding this structure is reused.
  ******************************************************************************/
+struct ts_table;
+
 typedef struct bl31_params {
 	param_header_t h;
 	image_info_t *bl31_image_info;
@@ -178,6 +192,7 @@ typedef struct bl31_params {
 	image_info_t *bl32_image_info;
 	entry_point_info_t *bl33_ep_info;
 	image_info_t *bl33_image_info;
+	struct ts_table *timestamps;
 } bl31_params_t;
 
 
@@ -210,6 +225,7 @@ int load_image(meminfo_t *mem_layout,
 	       uint64_t image_base,
 	       image_info_t *image_data,
 	       entry_point_info_t *entry_point_info);
+void copy_image(uintptr_t dst, uintptr_t src, size_t size);
 extern const char build_message[];
 extern const char version_string[];
 
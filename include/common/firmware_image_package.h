@@ -37,6 +37,12 @@
 /* This is used as a signature to validate the blob header */
 #define TOC_HEADER_NAME	0xAA640001
 
+/* This is used as a signature to validate a compressed payload header */
+#define LZ4_HEADER_NAME	0xAA640002
+
+/* ToC Entry flags */
+#define TOC_ENTRY_FLAG_LZ4	(1ULL << 0)
+
 
 /* ToC Entry UUIDs */
 #define UUID_TRUSTED_BOOT_FIRMWARE_BL2 \
@@ -63,4 +69,14 @@ typedef struct fip_toc_entry {
 	uint64_t	flags;
 } fip_toc_entry_t;
 
+/* Header at the start of a payload flagged with TOC_ENTRY_FLAG_LZ4. It is
+ * followed by the image compressed as a single LZ4 block. The size in the
+ * ToC entry covers both the header and the compressed data.
+ */
+typedef struct fip_lz4_header {
+	uint32_t	name;
+	uint32_t	reserved;
+	uint64_t	decoded_size;
+} fip_lz4_header_t;
+
 #endif /* __FIRMWARE_IMAGE_PACKAGE_H__ */
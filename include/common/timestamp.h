@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TIMESTAMP_H__
+#define __TIMESTAMP_H__
+
+/*******************************************************************************
+ * Boot profiling probe points. Each probe records the value of the physical
+ * counter (CNTPCT_EL0) when it is reached. The time spent in a boot phase is
+ * the difference between consecutive entries.
+ ******************************************************************************/
+#define TS_MAIN_ENTRY			0
+#define TS_PLATFORM_SETUP_DONE		1
+#define TS_XLAT_START			2
+#define TS_XLAT_DONE			3
+#define TS_SECURITY_SETUP_START		4
+#define TS_SECURITY_SETUP_DONE		5
+#define TS_IMAGE_LOAD_START		6
+#define TS_IMAGE_LOAD_DONE		7
+#define TS_RUNTIME_SVC_INIT_DONE	8
+#define TS_BL32_INIT_DONE		9
+#define TS_EXIT				10
+#define TS_MAX_ID			11
+
+/* Maximum number of probes recorded across all boot stages */
+#define TS_MAX_ENTRIES			32
+
+#ifndef __ASSEMBLY__
+
+#include <arch_helpers.h>
+#include <stdint.h>
+
+/* Boot stage that records a probe */
+#if IMAGE_BL1
+#define TS_IMAGE	1
+#elif IMAGE_BL2
+#define TS_IMAGE	2
+#elif IMAGE_BL31
+#define TS_IMAGE	31
+#else
+#define TS_IMAGE	32
+#endif
+
+typedef struct ts_entry {
+	uint64_t timestamp;
+	uint32_t id;
+	uint32_t image;
+} ts_entry_t;
+
+typedef struct ts_table {
+	uint32_t num_entries;
+	ts_entry_t entries[TS_MAX_ENTRIES];
+} ts_table_t;
+
+#if BOOT_TIMESTAMPS
+
+/* Table of probes recorded so far, including those of previous stages */
+extern ts_table_t ts_table;
+
+static inline void ts_record(unsigned int id)
+{
+	unsigned int i = ts_table.num_entries;
+
+	if (i < TS_MAX_ENTRIES) {
+		ts_table.entries[i].timestamp = read_cntpct_el0();
+		ts_table.entries[i].id = id;
+		ts_table.entries[i].image = TS_IMAGE;
+		ts_table.num_entries = i + 1;
+	}
+}
+
+void ts_import(const ts_table_t *from);
+void ts_export(ts_table_t *to);
+void ts_dump(void);
+
+#define TS_RECORD(id)	ts_record(id)
+
+#else
+
+#define TS_RECORD(id)
+
+#endif /* BOOT_TIMESTAMPS */
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __TIMESTAMP_H__ */
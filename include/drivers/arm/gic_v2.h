@@ -182,6 +182,13 @@ void gicd_set_isactiver(unsigned int, unsigned int);
 void gicd_set_icactiver(unsigned int, unsigned int);
 void gicd_set_ipriorityr(unsigned int, unsigned int, unsigned int);
 void gicd_set_itargetsr(unsigned int, unsigned int, unsigned int);
+void gicd_setup_sec_irqs(unsigned int base,
+			 unsigned int first_id,
+			 unsigned int num_ids,
+			 const unsigned int *irqs,
+			 unsigned int num_irqs,
+			 unsigned int pri,
+			 unsigned int iface);
 
 
 /*******************************************************************************
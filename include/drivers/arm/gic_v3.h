@@ -67,6 +67,9 @@
  * Function prototypes
  ******************************************************************************/
 uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr);
+uintptr_t gicv3_get_rdist_at(uintptr_t gicr_base,
+			     unsigned int pos,
+			     uint64_t mpidr);
 
 /*******************************************************************************
  * GIC Redistributor interface accessors
@@ -67,9 +67,14 @@ typedef struct io_dev_funcs {
 	int (*size)(io_entity_t *entity, size_t *length);
 	int (*read)(io_entity_t *entity, uintptr_t buffer, size_t length,
 			size_t *length_read);
+	int (*read_at)(io_entity_t *entity, size_t offset, uintptr_t buffer,
+			size_t length, size_t *length_read);
 	int (*write)(io_entity_t *entity, const uintptr_t buffer,
 			size_t length, size_t *length_written);
 	int (*close)(io_entity_t *entity);
+	int (*direct_address)(io_entity_t *entity, uintptr_t *address);
+	int (*encoding)(io_entity_t *entity, io_encoding_t *encoding,
+			size_t *decoded_size);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
 } io_dev_funcs_t;
@@ -33,6 +33,13 @@
 
 struct io_dev_connector;
 
+/* Number of accesses the FIP driver has made to its backend device */
+typedef struct fip_backend_stats {
+	unsigned int open_count;
+	unsigned int read_count;
+} fip_backend_stats_t;
+
 int register_io_dev_fip(const struct io_dev_connector **dev_con);
+void fip_get_backend_stats(fip_backend_stats_t *stats);
 
 #endif /* __IO_FIP_H__ */
@@ -56,6 +56,14 @@ typedef enum {
 } io_seek_mode_t;
 
 
+/* Encodings in which an entity's data may be stored on a device */
+typedef enum {
+	IO_ENCODING_NONE,
+	IO_ENCODING_LZ4,
+	IO_ENCODING_MAX
+} io_encoding_t;
+
+
 /* Connector type, providing a means of identifying a device to open */
 struct io_dev_connector;
 
@@ -115,10 +123,25 @@ int io_size(uintptr_t handle, size_t *length);
 int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
 		size_t *length_read);
 
+/* Read from an absolute offset in the entity. Drivers without a native
+ * implementation are driven with a seek followed by a read, so the entity's
+ * position afterwards is undefined; io_seek() before mixing with io_read() */
+int io_read_at(uintptr_t handle, size_t offset, uintptr_t buffer,
+		size_t length, size_t *length_read);
+
 int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 		size_t *length_written);
 
 int io_close(uintptr_t handle);
 
+/* Return the address at which the entity's data can be accessed in place,
+ * for devices that are directly memory-mapped */
+int io_get_direct_address(uintptr_t handle, uintptr_t *address);
+
+/* Return how the entity's data is encoded and the size it decodes to. The
+ * data returned by io_read() is left encoded */
+int io_get_encoding(uintptr_t handle, io_encoding_t *encoding,
+		size_t *decoded_size);
+
 
 #endif /* __IO_H__ */
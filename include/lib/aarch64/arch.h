@@ -108,6 +108,10 @@
 #define ID_AA64PFR0_EL3_SHIFT	12
 #define ID_AA64PFR0_ELX_MASK	0xf
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_SHA2_SHIFT	12
+#define ID_AA64ISAR0_SHA2_MASK	0xf
+
 /* ID_PFR1_EL1 definitions */
 #define ID_PFR1_VIRTEXT_SHIFT	12
 #define ID_PFR1_VIRTEXT_MASK	0xf
@@ -180,6 +184,16 @@
 #define TTA_BIT			(1 << 20)
 #define TFP_BIT			(1 << 10)
 
+/* MDCR_EL3 definitions */
+#define MDCR_SPME_BIT		(1 << 17)
+
+/* PMCR_EL0 definitions */
+#define PMCR_EL0_C_BIT		(1 << 2)
+#define PMCR_EL0_E_BIT		(1 << 0)
+
+/* PMCNTENSET_EL0 definitions */
+#define PMCNTENSET_EL0_C_BIT	(1u << 31)
+
 /* CPSR/SPSR definitions */
 #define DAIF_FIQ_BIT		(1 << 0)
 #define DAIF_IRQ_BIT		(1 << 1)
@@ -311,6 +325,11 @@
 #define clr_cntp_ctl_enable(x)  (x &= ~(1 << CNTP_CTL_ENABLE_SHIFT))
 #define clr_cntp_ctl_imask(x)   (x &= ~(1 << CNTP_CTL_IMASK_SHIFT))
 
+/* The virtual timer control register has the same bit fields */
+#define get_cntv_ctl_enable(x)  get_cntp_ctl_enable(x)
+#define get_cntv_ctl_imask(x)   get_cntp_ctl_imask(x)
+#define get_cntv_ctl_istatus(x) get_cntp_ctl_istatus(x)
+
 /* Miscellaneous MMU related constants */
 #define NUM_2MB_IN_GB		(1 << 9)
 #define NUM_4K_IN_2MB		(1 << 9)
@@ -35,11 +35,26 @@
 
 #define BAKERY_LOCK_MAX_CPUS		PLATFORM_CORE_COUNT
 
+#if PERCPU_BAKERY_LOCKS && IMAGE_BL31
+/*
+ * The ticket state of each CPU for every lock lives in a per-cpu, cache line
+ * sized and aligned slot in Normal memory (see bakery_lock_percpu.c). The lock
+ * itself only records the index of its state in these slots.
+ */
+#ifndef PLAT_MAX_BAKERY_LOCKS
+#error "PLAT_MAX_BAKERY_LOCKS must be defined to use per-cpu bakery locks"
+#endif
+
+typedef struct bakery_lock {
+	unsigned int id;
+} bakery_lock_t;
+#else
 typedef struct bakery_lock {
 	int owner;
 	volatile char entering[BAKERY_LOCK_MAX_CPUS];
 	volatile unsigned number[BAKERY_LOCK_MAX_CPUS];
 } bakery_lock_t;
+#endif
 
 #define NO_OWNER (-1)
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TICKET_LOCK_H__
+#define __TICKET_LOCK_H__
+
+#include <stdint.h>
+
+/*
+ * Ticket lock built on the exclusive access instructions. Contenders are served
+ * in the order in which they took their ticket and the cost of acquiring the
+ * lock does not depend on the number of CPUs.
+ *
+ * Like spinlock_t, it must only be used where all the contenders access it
+ * through a memory type on which exclusive accesses are supported i.e. with
+ * the MMU and data cache enabled. Locks taken on the power down and warm boot
+ * paths, where this is not the case, must remain bakery locks.
+ */
+typedef struct ticket_lock {
+	/* Next ticket in bits [31:16], ticket being served in bits [15:0] */
+	volatile uint32_t lock;
+} ticket_lock_t;
+
+void ticket_lock_init(ticket_lock_t *lock);
+void ticket_lock_get(ticket_lock_t *lock);
+void ticket_lock_release(ticket_lock_t *lock);
+int ticket_lock_try(ticket_lock_t *lock);
+
+#endif /* __TICKET_LOCK_H__ */
@@ -163,6 +163,16 @@ void bl2_plat_get_bl32_meminfo(struct meminfo *mem_info);
 /*******************************************************************************
  * Optional BL2 functions (may be overridden)
  ******************************************************************************/
+/*
+ * Used when BL2_PARALLEL_LOAD is enabled. The first function starts helper
+ * CPUs, each of which must call bl2_load_helper_main(), and returns how many
+ * were started. The second parks them again once they have returned from it.
+ */
+unsigned int bl2_plat_start_load_helpers(void);
+void bl2_plat_stop_load_helpers(void);
+
+/* Provided by BL2 for the helper CPUs started by the platform */
+void bl2_load_helper_main(void);
 
 /*******************************************************************************
  * Mandatory BL3-1 functions
@@ -34,6 +34,7 @@
 #include <cassert.h>
 #include <platform_def.h>
 #include <string.h>
+#include <timestamp.h>
 #include <xlat_tables.h>
 
 
@@ -275,10 +276,12 @@ static unsigned int calc_physical_addr_size_bits(unsigned long max_addr)
 
 void init_xlat_tables(void)
 {
+	TS_RECORD(TS_XLAT_START);
 	print_mmap();
 	init_xlation_table(mmap, 0, l1_xlation_table, 1);
 	tcr_ps_bits = calc_physical_addr_size_bits(max_pa);
 	assert(max_va < ADDR_SPACE_SIZE);
+	TS_RECORD(TS_XLAT_DONE);
 }
 
 /*******************************************************************************
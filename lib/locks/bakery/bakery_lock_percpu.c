@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bakery_lock.h>
+#include <debug.h>
+#include <platform.h>
+#include <stdint.h>
+
+/*
+ * Functions in this file implement Bakery Algorithm for mutual exclusion with
+ * the ticket state of each CPU kept in a per-cpu slot instead of the lock.
+ *
+ * In bakery_lock.c all contenders write their ticket state into adjacent
+ * bytes of the lock, which has to live in device memory. Here the state of
+ * all the locks for a given CPU is gathered in a slot which is the size of,
+ * and aligned to, the cache writeback granule. Only that CPU ever writes to
+ * its slot, so a CPU spinning on the state of a contender does not disturb
+ * the state of any other CPU, and the slots can live in Normal cacheable
+ * memory.
+ *
+ * CPUs may however access the slots with their data cache disabled, e.g. in
+ * the power down and warm boot paths. To keep all the CPUs in agreement
+ * irrespective of the state of their data cache, a CPU with its data cache
+ * enabled cleans its slot to memory after writing to it, and cleans and
+ * invalidates the slot of a contender before reading from it. As each slot
+ * has a single writer, no stale copy of a slot can overwrite its contents in
+ * memory.
+ *
+ * The ticket state of a CPU for a lock is a 16-bit value. Bit 15 is set while
+ * the CPU is choosing its ticket and bits [14:0] hold the ticket value.
+ */
+
+#define BAKERY_CHOOSING_BIT	(1 << 15)
+#define BAKERY_TICKET_MASK	(BAKERY_CHOOSING_BIT - 1)
+
+#define bakery_is_choosing(data)	((data) & BAKERY_CHOOSING_BIT)
+#define bakery_ticket(data)		((data) & BAKERY_TICKET_MASK)
+
+#define assert_bakery_entry_valid(entry, bakery) do {	\
+	assert(bakery);					\
+	assert(bakery->id < bakery_lock_count);		\
+	assert(entry < BAKERY_LOCK_MAX_CPUS);		\
+} while (0)
+
+/* Convert a ticket to priority */
+#define PRIORITY(t, pos)	(((t) << 8) | (pos))
+
+typedef struct bakery_info {
+	volatile uint16_t lock_data[PLAT_MAX_BAKERY_LOCKS];
+} __aligned(CACHE_WRITEBACK_GRANULE) bakery_info_t;
+
+static bakery_info_t bakery_info[BAKERY_LOCK_MAX_CPUS];
+static unsigned int bakery_lock_count;
+
+/* Returns non-zero if the accesses of this CPU go through its data cache */
+static int bakery_is_cached(void)
+{
+	return read_sctlr_el3() & SCTLR_C_BIT;
+}
+
+/* Read the ticket state of a CPU for a lock from memory */
+static unsigned int bakery_read(unsigned int cpu, unsigned int id, int cached)
+{
+	volatile uint16_t *data = &bakery_info[cpu].lock_data[id];
+
+	if (cached) {
+		dccivac((uint64_t) data);
+		dsb();
+	}
+
+	return *data;
+}
+
+/* Write the ticket state of this CPU for a lock and make it visible */
+static void bakery_write(unsigned int me, unsigned int id,
+			 unsigned int value, int cached)
+{
+	volatile uint16_t *data = &bakery_info[me].lock_data[id];
+
+	*data = value;
+	if (cached)
+		dccvac((uint64_t) data);
+	dsb();
+}
+
+
+/*
+ * Initialize Bakery Lock by allocating its ticket state in the per-cpu slots.
+ * This is expected to be called on the primary CPU during cold boot, before
+ * any other CPU may contend for the lock.
+ */
+void bakery_lock_init(bakery_lock_t *bakery)
+{
+	unsigned int cpu;
+
+	assert(bakery);
+
+	if (bakery_lock_count == PLAT_MAX_BAKERY_LOCKS) {
+		ERROR("Too many bakery locks. Increase PLAT_MAX_BAKERY_LOCKS\n");
+		panic();
+	}
+
+	bakery->id = bakery_lock_count++;
+
+	/* All ticket values need to be 0 */
+	for (cpu = 0; cpu < BAKERY_LOCK_MAX_CPUS; cpu++)
+		bakery_info[cpu].lock_data[bakery->id] = 0;
+
+	/*
+	 * Make the lock and its ticket state visible to CPUs which will access
+	 * them with their data cache disabled
+	 */
+	flush_dcache_range((uint64_t) bakery, sizeof(*bakery));
+	flush_dcache_range((uint64_t) bakery_info, sizeof(bakery_info));
+}
+
+
+/* Obtain a ticket for a given CPU */
+static unsigned int bakery_get_ticket(bakery_lock_t *bakery, unsigned int me,
+				      int cached)
+{
+	unsigned int my_ticket, their_ticket;
+	unsigned int they;
+
+	/*
+	 * Flag that we're busy getting our ticket. All CPUs are iterated in the
+	 * order of their ordinal position to decide the maximum ticket value
+	 * observed so far. Our priority is set to be greater than the maximum
+	 * observed priority
+	 *
+	 * Note that it's possible that more than one contender gets the same
+	 * ticket value. That's OK as the lock is acquired based on the priority
+	 * value, not the ticket value alone.
+	 */
+	my_ticket = 0;
+	bakery_write(me, bakery->id, BAKERY_CHOOSING_BIT, cached);
+	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		if (me == they)
+			continue;
+
+		their_ticket = bakery_ticket(bakery_read(they, bakery->id,
+							 cached));
+		if (their_ticket > my_ticket)
+			my_ticket = their_ticket;
+	}
+
+	/*
+	 * Compute ticket; then signal to other contenders waiting for us to
+	 * finish calculating our ticket value that we're done
+	 */
+	++my_ticket;
+	assert(my_ticket <= BAKERY_TICKET_MASK);
+	bakery_write(me, bakery->id, my_ticket, cached);
+	sev();
+
+	return my_ticket;
+}
+
+
+/*
+ * Acquire bakery lock
+ *
+ * The algorithm is the same as the one in bakery_lock.c: the contending CPU
+ * obtains a non-zero ticket, then waits for all the contenders with a higher
+ * priority (lower numerical value) to release the lock
+ */
+void bakery_lock_get(bakery_lock_t *bakery)
+{
+	unsigned int they, me, their_data;
+	unsigned int my_ticket, my_prio, their_ticket;
+	int cached;
+
+	me = platform_get_core_pos(read_mpidr_el1());
+
+	assert_bakery_entry_valid(me, bakery);
+
+	/* Prevent recursive acquisition */
+	assert(bakery_ticket(bakery_info[me].lock_data[bakery->id]) == 0);
+
+	cached = bakery_is_cached();
+
+	/* Get a ticket */
+	my_ticket = bakery_get_ticket(bakery, me, cached);
+
+	/*
+	 * Now that we got our ticket, compute our priority value, then compare
+	 * with that of others, and proceed to acquire the lock
+	 */
+	my_prio = PRIORITY(my_ticket, me);
+	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		if (me == they)
+			continue;
+
+		/* Wait for the contender to get their ticket */
+		their_data = bakery_read(they, bakery->id, cached);
+		while (bakery_is_choosing(their_data)) {
+			wfe();
+			their_data = bakery_read(they, bakery->id, cached);
+		}
+
+		/*
+		 * If the other party is a contender, they'll have non-zero
+		 * (valid) ticket value. If they do, compare priorities
+		 */
+		their_ticket = bakery_ticket(their_data);
+		if (their_ticket && (PRIORITY(their_ticket, they) < my_prio)) {
+			/*
+			 * They have higher priority (lower value). Wait for
+			 * their ticket value to change (either release the lock
+			 * to have it dropped to 0; or drop and probably content
+			 * again for the same lock to have an even higher value)
+			 */
+			do {
+				wfe();
+				their_data = bakery_read(they, bakery->id,
+							 cached);
+			} while (their_ticket == bakery_ticket(their_data));
+		}
+	}
+
+	/* Lock acquired */
+}
+
+
+/* Release the lock and signal contenders */
+void bakery_lock_release(bakery_lock_t *bakery)
+{
+	unsigned int me = platform_get_core_pos(read_mpidr_el1());
+
+	assert_bakery_entry_valid(me, bakery);
+	assert(bakery_ticket(bakery_info[me].lock_data[bakery->id]));
+
+	/*
+	 * Complete the accesses made in the critical section, then release the
+	 * lock by resetting our ticket. Then signal other waiting contenders
+	 */
+	dsb();
+	bakery_write(me, bakery->id, 0, bakery_is_cached());
+	sev();
+}
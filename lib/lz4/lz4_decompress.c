@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <io_storage.h>
+#include <lz4.h>
+#include <sha256.h>
+#include <string.h>
+
+/*
+ * Compressed data is pulled from the device through this buffer. Literal
+ * runs that do not fit in it are read straight to their destination.
+ */
+#define LZ4_CHUNK_SIZE		1024
+
+/* Matches are at least this long; the token stores the excess */
+#define LZ4_MIN_MATCH		4
+
+/*
+ * When a hash is requested, the output is added to it this many bytes at a
+ * time, while it is still in the data cache. Decoded bytes never change again
+ * since matches only read the output that precedes them.
+ */
+#define LZ4_HASH_SPAN		(4 * 1024)
+
+/* State of the compressed stream being read through the IO layer */
+typedef struct lz4_reader {
+	uintptr_t handle;
+	size_t remaining;	/* Bytes not yet read from the device */
+	const uint8_t *pos;
+	const uint8_t *end;
+} lz4_reader_t;
+
+static uint8_t lz4_chunk[LZ4_CHUNK_SIZE];
+
+/* Read the next chunk of the stream into the buffer */
+static int lz4_refill(lz4_reader_t *r)
+{
+	size_t length, bytes_read;
+	int result;
+
+	if (r->remaining == 0)
+		return -EINVAL;
+
+	length = (r->remaining < LZ4_CHUNK_SIZE) ?
+		r->remaining : LZ4_CHUNK_SIZE;
+	result = io_read(r->handle, (uintptr_t)lz4_chunk, length, &bytes_read);
+	if ((result != IO_SUCCESS) || (bytes_read != length))
+		return -EIO;
+
+	r->remaining -= length;
+	r->pos = lz4_chunk;
+	r->end = lz4_chunk + length;
+
+	return 0;
+}
+
+static int lz4_get_byte(lz4_reader_t *r, unsigned int *byte)
+{
+	int result;
+
+	if (r->pos == r->end) {
+		result = lz4_refill(r);
+		if (result != 0)
+			return result;
+	}
+	*byte = *r->pos++;
+
+	return 0;
+}
+
+/* Extend a length field with the 255-terminated bytes that follow a token */
+static int lz4_get_length(lz4_reader_t *r, size_t *length)
+{
+	unsigned int byte;
+	int result;
+
+	do {
+		result = lz4_get_byte(r, &byte);
+		if (result != 0)
+			return result;
+		*length += byte;
+	} while (byte == 255);
+
+	return 0;
+}
+
+/* Copy a run of literals from the stream to the output */
+static int lz4_copy_literals(lz4_reader_t *r, uint8_t *out, size_t length)
+{
+	size_t bytes_read, n;
+	int result;
+
+	while (length != 0) {
+		if ((r->pos == r->end) && (length >= LZ4_CHUNK_SIZE)) {
+			/* Long run: bypass the buffer */
+			if (length > r->remaining)
+				return -EINVAL;
+			result = io_read(r->handle, (uintptr_t)out, length,
+					 &bytes_read);
+			if ((result != IO_SUCCESS) || (bytes_read != length))
+				return -EIO;
+			r->remaining -= length;
+			return 0;
+		}
+
+		if (r->pos == r->end) {
+			result = lz4_refill(r);
+			if (result != 0)
+				return result;
+		}
+
+		n = r->end - r->pos;
+		if (n > length)
+			n = length;
+		memcpy(out, r->pos, n);
+		r->pos += n;
+		out += n;
+		length -= n;
+	}
+
+	return 0;
+}
+
+/* Hash the output decoded since the last call once there is enough of it */
+static void lz4_hash_output(sha256_ctx_t *hash, const uint8_t **hashed,
+			    const uint8_t *out, size_t min_length)
+{
+#if MEASURED_BOOT
+	if ((hash != NULL) && ((size_t)(out - *hashed) >= min_length)) {
+		sha256_update(hash, *hashed, out - *hashed);
+		*hashed = out;
+	}
+#endif
+}
+
+int lz4_decode_stream(uintptr_t handle, size_t src_size, uintptr_t dst,
+		      size_t dst_size, sha256_ctx_t *hash)
+{
+	lz4_reader_t r;
+	uint8_t *out = (uint8_t *)dst;
+	uint8_t *out_end = out + dst_size;
+	const uint8_t *match, *hashed = out;
+	unsigned int token, byte;
+	size_t length, offset;
+	int result;
+
+	assert(dst != (uintptr_t)NULL);
+
+	r.handle = handle;
+	r.remaining = src_size;
+	r.pos = r.end = lz4_chunk;
+
+	for (;;) {
+		result = lz4_get_byte(&r, &token);
+		if (result != 0)
+			return result;
+
+		/* Literals */
+		length = token >> 4;
+		if (length == 15) {
+			result = lz4_get_length(&r, &length);
+			if (result != 0)
+				return result;
+		}
+		if (length > (size_t)(out_end - out))
+			return -EINVAL;
+		result = lz4_copy_literals(&r, out, length);
+		if (result != 0)
+			return result;
+		out += length;
+		lz4_hash_output(hash, &hashed, out, LZ4_HASH_SPAN);
+
+		/* The last sequence has literals only */
+		if ((r.pos == r.end) && (r.remaining == 0))
+			break;
+
+		/* Match */
+		result = lz4_get_byte(&r, &byte);
+		if (result != 0)
+			return result;
+		offset = byte;
+		result = lz4_get_byte(&r, &byte);
+		if (result != 0)
+			return result;
+		offset |= byte << 8;
+		if ((offset == 0) || (offset > (size_t)(out - (uint8_t *)dst)))
+			return -EINVAL;
+
+		length = token & 0xf;
+		if (length == 15) {
+			result = lz4_get_length(&r, &length);
+			if (result != 0)
+				return result;
+		}
+		length += LZ4_MIN_MATCH;
+		if (length > (size_t)(out_end - out))
+			return -EINVAL;
+
+		/* The source may overlap the bytes being written */
+		match = out - offset;
+		if (offset >= length) {
+			memcpy(out, match, length);
+			out += length;
+		} else {
+			while (length-- != 0)
+				*out++ = *match++;
+		}
+		lz4_hash_output(hash, &hashed, out, LZ4_HASH_SPAN);
+	}
+
+	if (out != out_end)
+		return -EINVAL;
+	lz4_hash_output(hash, &hashed, out, 0);
+
+	return 0;
+}
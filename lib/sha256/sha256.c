@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <sha256.h>
+#include <string.h>
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)	(((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)	(((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SIGMA0(x)	(ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define SIGMA1(x)	(ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define GAMMA0(x)	(ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)	(ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+
+/*
+ * Portable implementation of the compression function. The message schedule
+ * is kept in a 16-word window to limit the stack usage.
+ */
+static void sha256_blocks_c(uint32_t state[8], const uint8_t *data,
+			    size_t blocks)
+{
+	uint32_t w[16];
+	uint32_t a, b, c, d, e, f, g, h, t1, t2;
+	int i;
+
+	for (; blocks != 0; blocks--, data += SHA256_BLOCK_SIZE) {
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0; i < 64; i++) {
+			if (i < 16)
+				w[i] = ((uint32_t)data[4 * i] << 24) |
+					((uint32_t)data[4 * i + 1] << 16) |
+					((uint32_t)data[4 * i + 2] << 8) |
+					(uint32_t)data[4 * i + 3];
+			else
+				w[i & 15] += GAMMA1(w[(i - 2) & 15]) +
+					w[(i - 7) & 15] +
+					GAMMA0(w[(i - 15) & 15]);
+
+			t1 = h + SIGMA1(e) + CH(e, f, g) + sha256_k[i] +
+				w[i & 15];
+			t2 = SIGMA0(a) + MAJ(a, b, c);
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+}
+
+static void sha256_blocks(uint32_t state[8], const uint8_t *data,
+			  size_t blocks)
+{
+#if SHA256_CRYPTO_EXT
+	/* Use the SHA-256 instructions where the CPU implements them */
+	if (((read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+	     ID_AA64ISAR0_SHA2_MASK) != 0) {
+		sha256_blocks_ce(state, data, blocks);
+		return;
+	}
+#endif
+	sha256_blocks_c(state, data, blocks);
+}
+
+void sha256_init(sha256_ctx_t *ctx)
+{
+	assert(ctx != NULL);
+
+	ctx->state[0] = 0x6a09e667;
+	ctx->state[1] = 0xbb67ae85;
+	ctx->state[2] = 0x3c6ef372;
+	ctx->state[3] = 0xa54ff53a;
+	ctx->state[4] = 0x510e527f;
+	ctx->state[5] = 0x9b05688c;
+	ctx->state[6] = 0x1f83d9ab;
+	ctx->state[7] = 0x5be0cd19;
+	ctx->length = 0;
+}
+
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	size_t used = ctx->length % SHA256_BLOCK_SIZE;
+	size_t n;
+
+	ctx->length += length;
+
+	/* Complete the partial block left by a previous update */
+	if (used != 0) {
+		n = SHA256_BLOCK_SIZE - used;
+		if (n > length)
+			n = length;
+		memcpy(ctx->block + used, p, n);
+		p += n;
+		length -= n;
+		if (used + n < SHA256_BLOCK_SIZE)
+			return;
+		sha256_blocks(ctx->state, ctx->block, 1);
+	}
+
+	/* Hash whole blocks in place and keep the remainder for later */
+	n = length / SHA256_BLOCK_SIZE;
+	if (n != 0)
+		sha256_blocks(ctx->state, p, n);
+	p += n * SHA256_BLOCK_SIZE;
+	length -= n * SHA256_BLOCK_SIZE;
+	memcpy(ctx->block, p, length);
+}
+
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+	size_t used = ctx->length % SHA256_BLOCK_SIZE;
+	uint64_t bits = ctx->length * 8;
+	int i;
+
+	/* Pad with 0x80, zeroes and the message length in bits */
+	ctx->block[used++] = 0x80;
+	if (used > SHA256_BLOCK_SIZE - 8) {
+		memset(ctx->block + used, 0, SHA256_BLOCK_SIZE - used);
+		sha256_blocks(ctx->state, ctx->block, 1);
+		used = 0;
+	}
+	memset(ctx->block + used, 0, SHA256_BLOCK_SIZE - 8 - used);
+	for (i = 0; i < 8; i++)
+		ctx->block[SHA256_BLOCK_SIZE - 1 - i] = bits >> (8 * i);
+	sha256_blocks(ctx->state, ctx->block, 1);
+
+	for (i = 0; i < 8; i++) {
+		digest[4 * i] = ctx->state[i] >> 24;
+		digest[4 * i + 1] = ctx->state[i] >> 16;
+		digest[4 * i + 2] = ctx->state[i] >> 8;
+		digest[4 * i + 3] = ctx->state[i];
+	}
+}
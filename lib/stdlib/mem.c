@@ -29,13 +29,59 @@
  */
 
 #include <stddef.h> /* size_t */
+#include <stdint.h>
 
+/*
+ * The bulk loops below operate on naturally aligned 64-bit words. Unaligned
+ * word accesses are never generated, so these routines remain safe to use
+ * while the MMU is off and all data accesses are treated as Device memory.
+ * When source and destination are not mutually aligned the byte loops are
+ * used instead.
+ */
+typedef uint64_t __attribute__((__may_alias__)) mem_word_t;
+
+#define WORD_SIZE		sizeof(mem_word_t)
+#define WORD_MASK		(WORD_SIZE - 1)
+
+#define is_word_aligned(p)	(((uintptr_t)(p) & WORD_MASK) == 0)
+#define is_mutually_aligned(a, b) \
+	((((uintptr_t)(a) ^ (uintptr_t)(b)) & WORD_MASK) == 0)
+
+#if !ASM_MEM_FUNCS
 /*
  * Fill @count bytes of memory pointed to by @dst with @val
  */
 void *memset(void *dst, int val, size_t count)
 {
-	char *ptr = dst;
+	unsigned char *ptr = dst;
+	mem_word_t *wptr;
+	mem_word_t fill;
+
+	while (count && !is_word_aligned(ptr)) {
+		*ptr++ = val;
+		count--;
+	}
+
+	if (count >= WORD_SIZE) {
+		/* Replicate the fill byte across a whole word */
+		fill = (unsigned char)val;
+		fill |= fill << 8;
+		fill |= fill << 16;
+		fill |= fill << 32;
+
+		wptr = (mem_word_t *)ptr;
+		while (count >= 2 * WORD_SIZE) {
+			wptr[0] = fill;
+			wptr[1] = fill;
+			wptr += 2;
+			count -= 2 * WORD_SIZE;
+		}
+		if (count >= WORD_SIZE) {
+			*wptr++ = fill;
+			count -= WORD_SIZE;
+		}
+		ptr = (unsigned char *)wptr;
+	}
 
 	while (count--)
 		*ptr++ = val;
@@ -48,16 +94,40 @@ void *memset(void *dst, int val, size_t count)
  */
 int memcmp(const void *s1, const void *s2, size_t len)
 {
-	const char *s = s1;
-	const char *d = s2;
-	char dc;
-	char sc;
+	const unsigned char *s = s1;
+	const unsigned char *d = s2;
+	const mem_word_t *ws;
+	const mem_word_t *wd;
+
+	if (is_mutually_aligned(s, d)) {
+		while (len && !is_word_aligned(s)) {
+			if (*s != *d)
+				return (*s - *d);
+			s++;
+			d++;
+			len--;
+		}
+
+		/*
+		 * Skip over identical words. The byte loop below locates the
+		 * first differing byte, if any.
+		 */
+		ws = (const mem_word_t *)s;
+		wd = (const mem_word_t *)d;
+		while (len >= WORD_SIZE && *ws == *wd) {
+			ws++;
+			wd++;
+			len -= WORD_SIZE;
+		}
+		s = (const unsigned char *)ws;
+		d = (const unsigned char *)wd;
+	}
 
 	while (len--) {
-		sc = *s++;
-		dc = *d++;
-		if (sc - dc)
-			return (sc - dc);
+		if (*s != *d)
+			return (*s - *d);
+		s++;
+		d++;
 	}
 
 	return 0;
@@ -68,8 +138,33 @@ int memcmp(const void *s1, const void *s2, size_t len)
  */
 void *memcpy(void *dst, const void *src, size_t len)
 {
-	const char *s = src;
-	char *d = dst;
+	const unsigned char *s = src;
+	unsigned char *d = dst;
+	const mem_word_t *ws;
+	mem_word_t *wd;
+
+	if (is_mutually_aligned(s, d)) {
+		while (len && !is_word_aligned(s)) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const mem_word_t *)s;
+		wd = (mem_word_t *)d;
+		while (len >= 2 * WORD_SIZE) {
+			wd[0] = ws[0];
+			wd[1] = ws[1];
+			ws += 2;
+			wd += 2;
+			len -= 2 * WORD_SIZE;
+		}
+		if (len >= WORD_SIZE) {
+			*wd++ = *ws++;
+			len -= WORD_SIZE;
+		}
+		s = (const unsigned char *)ws;
+		d = (unsigned char *)wd;
+	}
 
 	while (len--)
 		*d++ = *s++;
@@ -82,6 +177,11 @@ void *memcpy(void *dst, const void *src, size_t len)
  */
 void *memmove(void *dst, const void *src, size_t len)
 {
+	const unsigned char *s;
+	unsigned char *d;
+	const mem_word_t *ws;
+	mem_word_t *wd;
+
 	/*
 	 * The following test makes use of unsigned arithmetic overflow to
 	 * more efficiently test the condition !(src <= dst && dst < str+len).
@@ -93,16 +193,34 @@ void *memmove(void *dst, const void *src, size_t len)
 	if ((size_t)dst - (size_t)src >= len) {
 		/* destination not in source data, so can safely use memcpy */
 		return memcpy(dst, src, len);
-	} else {
-		/* copy backwards... */
-		const char *end = dst;
-		const char *s = (const char *)src + len;
-		char *d = (char *)dst + len;
-		while (d != end)
+	}
+
+	/* copy backwards... */
+	s = (const unsigned char *)src + len;
+	d = (unsigned char *)dst + len;
+
+	if (is_mutually_aligned(s, d)) {
+		while (len && !is_word_aligned(s)) {
 			*--d = *--s;
+			len--;
+		}
+
+		ws = (const mem_word_t *)s;
+		wd = (mem_word_t *)d;
+		while (len >= WORD_SIZE) {
+			*--wd = *--ws;
+			len -= WORD_SIZE;
+		}
+		s = (const unsigned char *)ws;
+		d = (unsigned char *)wd;
 	}
+
+	while (len--)
+		*--d = *--s;
+
 	return dst;
 }
+#endif /* ASM_MEM_FUNCS */
 
 /*
  * Scan @len bytes of @src for value @c
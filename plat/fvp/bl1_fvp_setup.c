@@ -72,6 +72,14 @@ void bl1_early_platform_setup(void)
 {
 	const size_t bl1_size = BL1_RAM_LIMIT - BL1_RAM_BASE;
 
+#if BOOT_TIMESTAMPS
+	/*
+	 * Enable the System level generic timer now rather than in BL3-1 so
+	 * that the boot timestamps recorded by BL1 and BL2 are meaningful.
+	 */
+	mmio_write_32(SYS_CNTCTL_BASE + CNTCR_OFF, CNTCR_FCREQ(0) | CNTCR_EN);
+#endif
+
 	/* Initialize the console to provide early debug support */
 	console_init(PL011_UART0_BASE, PL011_UART0_CLK_IN_HZ, PL011_BAUDRATE);
 
@@ -35,6 +35,7 @@
 #include <platform.h>
 #include <platform_def.h>
 #include <string.h>
+#include <timestamp.h>
 #include "fvp_def.h"
 #include "fvp_private.h"
 
@@ -113,6 +114,10 @@ bl31_params_t *bl2_plat_get_bl31_params(void)
 	bl2_to_bl31_params = &bl31_params_mem->bl31_params;
 	SET_PARAM_HEAD(bl2_to_bl31_params, PARAM_BL31, VERSION_1, 0);
 
+#if BOOT_TIMESTAMPS
+	bl2_to_bl31_params->timestamps = &bl31_params_mem->timestamps;
+#endif
+
 	/* Fill BL31 related information */
 	bl31_ep_info = &bl31_params_mem->bl31_ep_info;
 	bl2_to_bl31_params->bl31_image_info = &bl31_params_mem->bl31_image_info;
@@ -186,7 +191,9 @@ void bl2_platform_setup(void)
 	 * other platforms might have more programmable security devices
 	 * present.
 	 */
+	TS_RECORD(TS_SECURITY_SETUP_START);
 	fvp_security_setup();
+	TS_RECORD(TS_SECURITY_SETUP_DONE);
 
 	/* Initialise the IO layer and register platform IO devices */
 	fvp_io_setup();
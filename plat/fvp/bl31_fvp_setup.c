@@ -180,6 +180,11 @@ void bl31_early_platform_setup(bl31_params_t *from_bl2,
 
 	bl2_to_bl31_params = from_bl2;
 	assert(((unsigned long)plat_params_from_bl2) == FVP_BL31_PLAT_PARAM_VAL);
+
+#if BOOT_TIMESTAMPS
+	/* Take over the probes recorded by BL1 and BL2 */
+	ts_import(from_bl2->timestamps);
+#endif
 #endif
 }
 
@@ -192,6 +192,14 @@
 /* FVP Power controller base address*/
 #define PWRC_BASE		0x1c100000
 
+/*
+ * State ID of the cpu power down state which the FVP serves as a retention
+ * state, i.e. without asking the power controller to power the cpu down. Small
+ * State IDs such as 1 are left alone since existing callers already pass them
+ * with ordinary power down requests, which must keep powering the cpu down.
+ */
+#define FVP_PSTATE_ID_RETENTION	0x100
+
 
 /*******************************************************************************
  * CCI-400 related constants
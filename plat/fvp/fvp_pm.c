@@ -143,6 +143,16 @@ int fvp_affinst_standby(unsigned int power_state)
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * FVP handler called to find out whether a cpu power down state is a retention
+ * state. The cpu then only waits for an interrupt in fvp_affinst_standby() and
+ * keeps its context.
+ ******************************************************************************/
+static int fvp_affinst_is_retention(unsigned int power_state)
+{
+	return (psci_get_pstate_id(power_state)) == FVP_PSTATE_ID_RETENTION;
+}
+
 /*******************************************************************************
  * FVP handler called when an affinity instance is about to be turned on. The
  * level and mpidr determine the affinity instance.
@@ -338,11 +348,32 @@ static void __dead2 fvp_system_reset(void)
 	panic();
 }
 
+/*******************************************************************************
+ * FVP idle states, from the shallowest to the deepest: cpu standby, cpu
+ * retention, cpu power down and cluster power down. The latencies are the ones
+ * the normal world software uses for the Base FVP, the retention state costs
+ * as much as standby.
+ ******************************************************************************/
+static const plat_idle_state_t fvp_idle_states[] = {
+	{ 0x00000000, 1, 1, 1 },
+	{ 0x00010000 | FVP_PSTATE_ID_RETENTION, 1, 1, 1 },
+	{ 0x00010000, 40, 100, 150 },
+	{ 0x01010000, 500, 1000, 2500 },
+};
+
+static unsigned int fvp_get_idle_states(const plat_idle_state_t **states)
+{
+	*states = fvp_idle_states;
+	return sizeof(fvp_idle_states) / sizeof(fvp_idle_states[0]);
+}
+
 /*******************************************************************************
  * Export the platform handlers to enable psci to invoke them
  ******************************************************************************/
 static const plat_pm_ops_t fvp_plat_pm_ops = {
 	.affinst_standby = fvp_affinst_standby,
+	.affinst_is_retention = fvp_affinst_is_retention,
+	.get_idle_states = fvp_get_idle_states,
 	.affinst_on = fvp_affinst_on,
 	.affinst_off = fvp_affinst_off,
 	.affinst_suspend = fvp_affinst_suspend,
@@ -33,6 +33,7 @@
 
 #include <bl_common.h>
 #include <platform_def.h>
+#include <timestamp.h>
 
 
 typedef volatile struct mailbox {
@@ -53,6 +54,9 @@ typedef struct bl2_to_bl31_params_mem {
 	entry_point_info_t bl33_ep_info;
 	entry_point_info_t bl32_ep_info;
 	entry_point_info_t bl31_ep_info;
+#if BOOT_TIMESTAMPS
+	ts_table_t timestamps;
+#endif
 } bl2_to_bl31_params_mem_t;
 
 /*******************************************************************************
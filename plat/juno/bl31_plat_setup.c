@@ -139,6 +139,11 @@ void bl31_early_platform_setup(bl31_params_t *from_bl2,
 	 */
 	bl32_ep_info = *from_bl2->bl32_ep_info;
 	bl33_ep_info = *from_bl2->bl33_ep_info;
+
+#if BOOT_TIMESTAMPS
+	/* Take over the probes recorded by BL1 and BL2 */
+	ts_import(from_bl2->timestamps);
+#endif
 }
 
 /*******************************************************************************
@@ -72,8 +72,16 @@
 #define PLATFORM_CORE_COUNT             6
 #define PLATFORM_NUM_AFFS		(PLATFORM_CLUSTER_COUNT + \
 					 PLATFORM_CORE_COUNT)
+/*
+ * One bakery lock per affinity instance for PSCI, one more per cluster for the
+ * reference counts of PSCI_LOCKLESS_CPU_STATE and one for the MHU secure
+ * channel
+ */
+#define PLAT_MAX_BAKERY_LOCKS		(PLATFORM_NUM_AFFS + \
+					 PLATFORM_CLUSTER_COUNT + 1)
 #define MAX_IO_DEVICES			3
 #define MAX_IO_HANDLES			4
+#define MAX_FIP_FILES			2
 
 /*******************************************************************************
  * Platform memory map related constants
@@ -34,6 +34,7 @@
 #include <bl_common.h>
 #include <platform_def.h>
 #include <stdint.h>
+#include <timestamp.h>
 
 /*******************************************************************************
  * Forward declarations
@@ -57,6 +58,9 @@ typedef struct bl2_to_bl31_params_mem {
 	struct entry_point_info bl33_ep_info;
 	struct entry_point_info bl32_ep_info;
 	struct entry_point_info bl31_ep_info;
+#if BOOT_TIMESTAMPS
+	struct ts_table timestamps;
+#endif
 } bl2_to_bl31_params_mem_t;
 
 /*******************************************************************************
@@ -76,7 +76,13 @@ static int32_t juno_do_plat_actions(uint32_t afflvl, uint32_t state)
 	 */
 	max_phys_off_afflvl = psci_get_max_phys_off_afflvl();
 	assert(max_phys_off_afflvl != PSCI_INVALID_DATA);
+#if !PSCI_OS_INIT_MODE
+	/*
+	 * In OS-initiated mode, a cpu suspended at a lower affinity level can
+	 * wake up in a cluster powered off by the last cpu in it.
+	 */
 	assert(psci_get_suspend_afflvl() >= max_phys_off_afflvl);
+#endif
 	if (afflvl != max_phys_off_afflvl)
 		return -EAGAIN;
 
@@ -274,6 +280,22 @@ static void __dead2 juno_system_reset(void)
 	panic();
 }
 
+/*******************************************************************************
+ * Juno idle states, from the shallowest to the deepest: cpu power down and
+ * cluster power down. The latencies are the ones the normal world software
+ * uses for Juno.
+ ******************************************************************************/
+static const plat_idle_state_t juno_idle_states[] = {
+	{ 0x00010000, 300, 1200, 2000 },
+	{ 0x01010000, 400, 1200, 2500 },
+};
+
+static unsigned int juno_get_idle_states(const plat_idle_state_t **states)
+{
+	*states = juno_idle_states;
+	return sizeof(juno_idle_states) / sizeof(juno_idle_states[0]);
+}
+
 /*******************************************************************************
  * Export the platform handlers to enable psci to invoke them
  ******************************************************************************/
@@ -283,6 +305,7 @@ static const plat_pm_ops_t juno_ops = {
 	.affinst_off		= juno_affinst_off,
 	.affinst_suspend	= juno_affinst_suspend,
 	.affinst_suspend_finish	= juno_affinst_suspend_finish,
+	.get_idle_states	= juno_get_idle_states,
 	.system_off		= juno_system_off,
 	.system_reset		= juno_system_reset
 };
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <debug.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <runtime_svc.h>
+#include <sip_svc.h>
+#include <smc_stats.h>
+#include <stdint.h>
+#include <uuid.h>
+
+/* SiP Service UUID */
+DEFINE_SVC_UUID(sip_svc_uid,
+		0x6b4ff5e9, 0x1e86, 0x4c63, 0x9a, 0x63,
+		0x2d, 0x0b, 0xd8, 0x9f, 0x58, 0x31);
+
+#if SMC_STATS
+/*
+ * Return the statistics of an SMC function ID, or of all the function IDs of
+ * an owning entity, packed as described in sip_svc.h
+ */
+static uint64_t sip_svc_smc_stats(uint32_t smc_fid,
+				  uint64_t x1,
+				  uint64_t x2,
+				  void *handle)
+{
+	const smc_stats_entry_t *entry;
+	smc_stats_entry_t oen_stats;
+
+	switch (smc_fid) {
+	case SIP_SVC_SMC_STATS_GET:
+		entry = smc_stats_get_entry(x1, x2);
+		if (entry == NULL)
+			SMC_RET1(handle, SMC_UNK);
+		SMC_RET4(handle, entry->smc_fid, entry->count,
+			 entry->total_ticks,
+			 ((uint64_t)entry->max_ticks << 32) | entry->min_ticks);
+
+	case SIP_SVC_SMC_STATS_GET_OEN:
+		if (smc_stats_get_oen(x1, x2, &oen_stats))
+			SMC_RET1(handle, SMC_UNK);
+		SMC_RET4(handle, 0, oen_stats.count, oen_stats.total_ticks,
+			 ((uint64_t)oen_stats.max_ticks << 32) |
+			 oen_stats.min_ticks);
+
+	default:
+		if (x1 >= PLATFORM_CORE_COUNT)
+			SMC_RET1(handle, SMC_UNK);
+		smc_stats_reset(x1);
+		SMC_RET1(handle, 0);
+	}
+}
+#endif
+
+/*
+ * Top-level SiP Service SMC handler
+ */
+uint64_t sip_svc_smc_handler(uint32_t smc_fid,
+			     uint64_t x1,
+			     uint64_t x2,
+			     uint64_t x3,
+			     uint64_t x4,
+			     void *cookie,
+			     void *handle,
+			     uint64_t flags)
+{
+	uint64_t on_map;
+	int rc;
+
+	switch (smc_fid) {
+#if SMC_STATS
+	case SIP_SVC_SMC_STATS_GET:
+	case SIP_SVC_SMC_STATS_GET_OEN:
+	case SIP_SVC_SMC_STATS_RESET:
+		return sip_svc_smc_stats(smc_fid, x1, x2, handle);
+#endif
+
+	case SIP_SVC_CPU_SUSPEND_LATENCY:
+		if (is_caller_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+		SMC_RET1(handle, psci_cpu_suspend_latency(x1, x2, x3));
+
+	case SIP_SVC_CPU_ON_BATCH:
+		if (is_caller_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+		rc = psci_cpu_on_batch(x1, x2, x3, x4, &on_map);
+		SMC_RET2(handle, rc, on_map);
+
+#if PSCI_STATS
+	case SIP_SVC_PSCI_STAT_EXIT_LATENCY:
+		if (is_caller_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+		SMC_RET1(handle, psci_stat_exit_latency(x1, x2));
+#endif
+
+	case SIP_SVC_CALL_COUNT:
+		/* Return the number of SiP Service Calls */
+		SMC_RET1(handle, SIP_SVC_NUM_CALLS);
+
+	case SIP_SVC_UID:
+		/* Return UID to the caller */
+		SMC_UUID_RET(handle, sip_svc_uid);
+
+	case SIP_SVC_VERSION:
+		/* Return the version of current implementation */
+		SMC_RET2(handle, SIP_SVC_VERSION_MAJOR, SIP_SVC_VERSION_MINOR);
+
+	default:
+		WARN("Unimplemented SiP Service Call: 0x%x \n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
+
+/* Register SiP Service Calls as runtime service */
+DECLARE_RT_SVC(
+		sip_svc,
+
+		OEN_SIP_START,
+		OEN_SIP_END,
+		SMC_TYPE_FAST,
+		NULL,
+		sip_svc_smc_handler
+);
@@ -36,6 +36,14 @@ SPD_SOURCES		:=	services/spd/tspd/tspd_common.c		\
 				services/spd/tspd/tspd_main.c		\
 				services/spd/tspd/tspd_pm.c
 
+# Flag used to make the TSPD save only the volatile subset of the S-EL1 system
+# registers when the TSP exits to the normal world, the others being saved only
+# after a power event or when the TSP reports that it has changed them
+TSPD_PARTIAL_SYSREGS_SAVE	:=	0
+
+$(eval $(call assert_boolean,TSPD_PARTIAL_SYSREGS_SAVE))
+$(eval $(call add_define,TSPD_PARTIAL_SYSREGS_SAVE))
+
 # This dispatcher is paired with a Test Secure Payload source and we intend to
 # build the Test Secure Payload along with this dispatcher.
 #
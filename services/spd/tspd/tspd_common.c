@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <context_mgmt.h>
+#include <debug.h>
 #include <string.h>
 #include "tspd_private.h"
 
@@ -66,6 +67,11 @@ void tspd_init_tsp_ep_state(struct entry_point_info *tsp_entry_point,
 
 	cm_set_context(&tsp_ctx->cpu_ctx, SECURE);
 
+#if TSP_SMC_BENCHMARK
+	/* Let the TSP count cpu cycles in the secure world */
+	write_mdcr_el3(MDCR_SPME_BIT);
+#endif
+
 	/* initialise an entrypoint to set up the CPU context */
 	ep_attr = SECURE | EP_ST_ENABLE;
 	if (read_sctlr_el3() & SCTLR_EE_BIT)
@@ -119,9 +125,14 @@ uint64_t tspd_synchronous_sp_entry(tsp_context_t *tsp_ctx)
 void tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret)
 {
 	assert(tsp_ctx != NULL);
-	/* Save the Secure EL1 system register context */
+	/*
+	 * Save the whole Secure EL1 system register context. A synchronous
+	 * entry initialises the TSP or follows a power event, either of which
+	 * may have changed any of these registers.
+	 */
 	assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
 	cm_el1_sysregs_context_save(SECURE);
+	clr_sysregs_dirty_flag(tsp_ctx->state);
 
 	assert(tsp_ctx->c_rt_ctx != 0);
 	tspd_exit_sp(tsp_ctx->c_rt_ctx, ret);
@@ -129,3 +140,61 @@ void tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret)
 	/* Should never reach here */
 	assert(0);
 }
+
+/*******************************************************************************
+ * This function saves the S-EL1 system register context of the TSP when it
+ * exits to the normal world. If TSPD_PARTIAL_SYSREGS_SAVE is set, only the
+ * volatile subset is saved unless the TSP has reported a change to the other
+ * registers since the last time its whole context was saved.
+ ******************************************************************************/
+void tspd_save_sp_sysregs(tsp_context_t *tsp_ctx)
+{
+	assert(tsp_ctx != NULL);
+	assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
+
+#if TSPD_PARTIAL_SYSREGS_SAVE
+	if (!get_sysregs_dirty_flag(tsp_ctx->state)) {
+		cm_el1_sysregs_context_save_volatile(SECURE);
+		return;
+	}
+#endif
+
+	cm_el1_sysregs_context_save(SECURE);
+	clr_sysregs_dirty_flag(tsp_ctx->state);
+}
+
+#if TSP_SMC_BENCHMARK
+#define TSPD_SYSREGS_SAVE_ITERATIONS	1024
+
+/*******************************************************************************
+ * This function prints the average number of cpu cycles taken to save the
+ * whole and the volatile S-EL1 system register context of the TSP on this cpu,
+ * i.e. the cost of tspd_save_sp_sysregs() without and with
+ * TSPD_PARTIAL_SYSREGS_SAVE. It must be called right after a synchronous exit
+ * from the TSP so that the S-EL1 registers still hold the TSP's state and
+ * saving them again leaves its context unchanged.
+ ******************************************************************************/
+void tspd_sysregs_save_benchmark(void)
+{
+	uint64_t start, full, volatile_only;
+	unsigned int i;
+
+	isb();
+	start = read_pmccntr_el0();
+	for (i = 0; i < TSPD_SYSREGS_SAVE_ITERATIONS; i++)
+		cm_el1_sysregs_context_save(SECURE);
+	isb();
+	full = read_pmccntr_el0() - start;
+
+	start = read_pmccntr_el0();
+	for (i = 0; i < TSPD_SYSREGS_SAVE_ITERATIONS; i++)
+		cm_el1_sysregs_context_save_volatile(SECURE);
+	isb();
+	volatile_only = read_pmccntr_el0() - start;
+
+	NOTICE("TSPD: cpu 0x%lx S-EL1 sysregs save: full %lu, volatile %lu cycles\n",
+		read_mpidr(),
+		full / TSPD_SYSREGS_SAVE_ITERATIONS,
+		volatile_only / TSPD_SYSREGS_SAVE_ITERATIONS);
+}
+#endif
@@ -226,6 +226,10 @@ int32_t tspd_init(void)
 	rc = tspd_synchronous_sp_entry(tsp_ctx);
 	assert(rc != 0);
 
+#if TSP_SMC_BENCHMARK
+	tspd_sysregs_save_benchmark();
+#endif
+
 	return rc;
 }
 
@@ -271,7 +275,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			SMC_RET1(handle, SMC_UNK);
 
 		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
+		tspd_save_sp_sysregs(tsp_ctx);
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
@@ -340,7 +344,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		assert(get_std_smc_active_flag(tsp_ctx->state));
 
 		/* Save the secure system register state */
-		cm_el1_sysregs_context_save(SECURE);
+		tspd_save_sp_sysregs(tsp_ctx);
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
@@ -452,18 +456,21 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 		/*
 		 * Request from non-secure client to perform an
-		 * arithmetic operation or response from secure
-		 * payload to an earlier request.
+		 * arithmetic operation or a null call used to
+		 * measure the latency of the round trip, or response
+		 * from secure payload to an earlier request.
 		 */
 	case TSP_FAST_FID(TSP_ADD):
 	case TSP_FAST_FID(TSP_SUB):
 	case TSP_FAST_FID(TSP_MUL):
 	case TSP_FAST_FID(TSP_DIV):
+	case TSP_FAST_FID(TSP_NULL):
 
 	case TSP_STD_FID(TSP_ADD):
 	case TSP_STD_FID(TSP_SUB):
 	case TSP_STD_FID(TSP_MUL):
 	case TSP_STD_FID(TSP_DIV):
+	case TSP_STD_FID(TSP_NULL):
 		if (ns) {
 			/*
 			 * This is a fresh request from the non-secure client.
@@ -520,7 +527,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * and return to the non-secure state.
 			 */
 			assert(handle == cm_get_context(SECURE));
-			cm_el1_sysregs_context_save(SECURE);
+			tspd_save_sp_sysregs(tsp_ctx);
 
 			/* Get a reference to the non-secure context */
 			ns_cpu_context = cm_get_context(NON_SECURE);
@@ -585,6 +592,18 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		get_tsp_args(tsp_ctx, x1, x2);
 		SMC_RET2(handle, x1, x2);
 
+		/*
+		 * This is a notification from the secure payload that it has
+		 * changed S-EL1 system registers outside the volatile subset.
+		 * Make sure that they are all saved when it next exits.
+		 */
+	case TSP_SYSREGS_CHANGED:
+		if (ns)
+			SMC_RET1(handle, SMC_UNK);
+
+		set_sysregs_dirty_flag(tsp_ctx->state);
+		SMC_RET0(handle);
+
 	case TOS_CALL_COUNT:
 		/*
 		 * Return the number of service function IDs implemented to
@@ -607,6 +626,24 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 	SMC_RET1(handle, SMC_UNK);
 }
 
+#if SMC_LEAF_HANDLERS
+/*******************************************************************************
+ * Return the number of service function IDs implemented by the TSP. This is
+ * served directly from the SMC exception vector.
+ ******************************************************************************/
+static uint64_t tspd_call_count_leaf_handler(uint32_t smc_fid,
+					     uint64_t x1,
+					     uint64_t x2,
+					     uint64_t x3,
+					     uint64_t flags)
+{
+	return TSP_NUM_FID;
+}
+
+DECLARE_RT_SVC_LEAF(tspd_call_count, TOS_CALL_COUNT,
+		    tspd_call_count_leaf_handler);
+#endif
+
 /* Define a SPD runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
 	tspd_fast,
@@ -146,6 +146,10 @@ static void tspd_cpu_on_finish_handler(uint64_t cookie)
 	if (rc != 0)
 		panic();
 
+#if TSP_SMC_BENCHMARK
+	tspd_sysregs_save_benchmark();
+#endif
+
 	/* Update its context to reflect the state the SP is in */
 	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON);
 }
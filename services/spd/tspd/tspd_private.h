@@ -75,6 +75,22 @@
 					 ~(STD_SMC_ACTIVE_FLAG_MASK           \
 					   << STD_SMC_ACTIVE_FLAG_SHIFT))
 
+/*
+ * This flag is set when the TSP reports that it has changed S-EL1 system
+ * registers other than the volatile subset saved by
+ * cm_el1_sysregs_context_save_volatile(). It makes the TSPD save the whole
+ * S-EL1 system register context the next time the TSP exits.
+ */
+#define SYSREGS_DIRTY_FLAG_SHIFT	3
+#define SYSREGS_DIRTY_FLAG_MASK		1
+#define get_sysregs_dirty_flag(state)	((state >> SYSREGS_DIRTY_FLAG_SHIFT)  \
+					 & SYSREGS_DIRTY_FLAG_MASK)
+#define set_sysregs_dirty_flag(state)	(state |=                             \
+					 1 << SYSREGS_DIRTY_FLAG_SHIFT)
+#define clr_sysregs_dirty_flag(state)	(state &=                             \
+					 ~(SYSREGS_DIRTY_FLAG_MASK            \
+					   << SYSREGS_DIRTY_FLAG_SHIFT))
+
 /*******************************************************************************
  * Secure Payload execution state information i.e. aarch32 or aarch64
  ******************************************************************************/
@@ -192,10 +208,14 @@ uint64_t tspd_enter_sp(uint64_t *c_rt_ctx);
 void __dead2 tspd_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
 uint64_t tspd_synchronous_sp_entry(tsp_context_t *tsp_ctx);
 void __dead2 tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret);
+void tspd_save_sp_sysregs(tsp_context_t *tsp_ctx);
 void tspd_init_tsp_ep_state(struct entry_point_info *tsp_ep,
 				uint32_t rw,
 				uint64_t pc,
 				tsp_context_t *tsp_ctx);
+#if TSP_SMC_BENCHMARK
+void tspd_sysregs_save_benchmark(void);
+#endif
 
 extern tsp_context_t tspd_sp_context[TSPD_CORE_COUNT];
 extern struct tsp_vectors *tsp_vectors;
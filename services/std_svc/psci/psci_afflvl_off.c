@@ -31,6 +31,8 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <bl_common.h>
+#include <context_mgmt.h>
 #include <string.h>
 #include "psci_private.h"
 
@@ -62,6 +64,14 @@ static int psci_afflvl0_off(aff_map_node_t *cpu_node)
 			return rc;
 	}
 
+#if CTX_LAZY_FPREGS
+	/*
+	 * Generic management: Save the FP/SIMD registers in the context that
+	 * owns them before they lose their contents
+	 */
+	cm_fpregs_flush();
+#endif
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
 	 * cpu caches.
@@ -193,6 +203,7 @@ int psci_afflvl_off(int start_afflvl,
 	int rc = PSCI_E_SUCCESS;
 	mpidr_aff_map_nodes_t mpidr_nodes;
 	unsigned int max_phys_off_afflvl;
+	uint32_t locked_afflvls;
 
 	/*
 	 * Collect the pointers to the nodes in the topology tree for
@@ -208,27 +219,17 @@ int psci_afflvl_off(int start_afflvl,
 	assert (rc == PSCI_E_SUCCESS);
 
 	/*
-	 * This function acquires the lock corresponding to each affinity
-	 * level so that by the time all locks are taken, the system topology
-	 * is snapshot and state management can be done safely.
-	 */
-	psci_acquire_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
-
-	/*
-	 * This function updates the state of each affinity instance
-	 * corresponding to the mpidr in the range of affinity levels
-	 * specified.
+	 * This function synchronises with the other cpus which change the
+	 * state of the affinity instances in our mpidr, updates the state of
+	 * each affinity instance in the range of affinity levels specified and
+	 * finds the highest affinity level which will be physically powered
+	 * off.
 	 */
-	psci_do_afflvl_state_mgmt(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes,
-				  PSCI_STATE_OFF);
-
-	max_phys_off_afflvl = psci_find_max_phys_off_afflvl(start_afflvl,
-							   end_afflvl,
-							   mpidr_nodes);
+	max_phys_off_afflvl = psci_afflvl_pwrdn_begin(start_afflvl,
+						      end_afflvl,
+						      mpidr_nodes,
+						      PSCI_STATE_OFF,
+						      &locked_afflvls);
 	assert(max_phys_off_afflvl != PSCI_INVALID_DATA);
 
 	/* Stash the highest affinity level that will enter the OFF state. */
@@ -249,11 +250,13 @@ int psci_afflvl_off(int start_afflvl,
 
 	/*
 	 * Release the locks corresponding to each affinity level in the
-	 * reverse order to which they were acquired.
+	 * reverse order to which they were acquired and let the cpus waiting
+	 * for this cpu to complete its power down operations proceed.
 	 */
-	psci_release_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
+	psci_afflvl_pwrdn_end(start_afflvl,
+			      end_afflvl,
+			      mpidr_nodes,
+			      locked_afflvls);
 
 	return rc;
 }
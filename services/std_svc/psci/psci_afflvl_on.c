@@ -52,6 +52,15 @@ static int cpu_on_validate_state(aff_map_node_t *node)
 {
 	unsigned int psci_state;
 
+	/*
+	 * The caller has waited for the cpu to stop powering itself down before
+	 * taking the locks. A cpu which has started powering down since then
+	 * was still on at that point. It must not be waited for here as it may
+	 * need the locks held by the caller to complete.
+	 */
+	if (*(volatile unsigned char *) &node->state & PSCI_AFF_PWRDN_PENDING)
+		return PSCI_E_ALREADY_ON;
+
 	/* Get the raw psci state */
 	psci_state = psci_get_state(node);
 
@@ -283,6 +292,11 @@ int psci_afflvl_on(unsigned long target_cpu,
 	if (rc != PSCI_E_SUCCESS)
 		return rc;
 
+	/*
+	 * Wait for the cpu to stop powering itself down, as it may need the
+	 * locks of the higher affinity levels to complete.
+	 */
+	psci_get_stable_state(target_cpu_nodes[MPIDR_AFFLVL0]);
 
 	/*
 	 * This function acquires the lock corresponding to each affinity
@@ -445,3 +459,104 @@ const afflvl_power_on_finisher_t psci_afflvl_on_finishers[] = {
 	psci_afflvl1_on_finish,
 	psci_afflvl2_on_finish,
 };
+
+/*******************************************************************************
+ * Generic handler which is called to physically power on several cpus in the
+ * same cluster, identified by the mpidr of the cluster 'cluster_mpidr' and the
+ * bitmap of their affinity level 0 values 'aff0_map'. It does the same as
+ * psci_afflvl_on() for each cpu, with the same entrypoint and context id, but
+ * takes the locks of the affinity instances above the cpus only once for all
+ * of them. The cpus which are turned on are set in 'on_map'. The first error
+ * returned for any cpu is returned.
+ *
+ * The locks of the cpus are taken before the locks of the higher affinity
+ * levels, in ascending order of mpidr, to follow the order in which a cpu
+ * takes them when it powers itself down or up.
+ ******************************************************************************/
+int psci_afflvl_on_batch(unsigned long cluster_mpidr,
+			 uint64_t aff0_map,
+			 unsigned long entrypoint,
+			 unsigned long context_id,
+			 int end_afflvl,
+			 uint64_t *on_map)
+{
+	int rc, ret = PSCI_E_SUCCESS;
+	unsigned int aff0;
+	unsigned long target_cpu;
+	mpidr_aff_map_nodes_t target_cpu_nodes;
+	aff_map_node_t *node;
+
+	assert(aff0_map);
+
+	/*
+	 * Collect the pointers to the nodes of the affinity instances shared by
+	 * all the cpus from the first one.
+	 */
+	target_cpu = cluster_mpidr | (__builtin_ctzl(aff0_map) <<
+				      MPIDR_AFF0_SHIFT);
+	rc = psci_get_aff_map_nodes(target_cpu,
+				    MPIDR_AFFLVL0,
+				    end_afflvl,
+				    target_cpu_nodes);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	for (aff0 = 0; aff0 < 64; aff0++) {
+		if (!(aff0_map & (1UL << aff0)))
+			continue;
+
+		/* Wait for the cpu to stop powering down, see psci_afflvl_on() */
+		target_cpu = cluster_mpidr | (aff0 << MPIDR_AFF0_SHIFT);
+		node = psci_get_aff_map_node(target_cpu, MPIDR_AFFLVL0);
+		psci_get_stable_state(node);
+		bakery_lock_get(&node->lock);
+	}
+
+	psci_acquire_afflvl_locks(MPIDR_AFFLVL1,
+				  end_afflvl,
+				  target_cpu_nodes);
+
+	*on_map = 0;
+	for (aff0 = 0; aff0 < 64; aff0++) {
+		if (!(aff0_map & (1UL << aff0)))
+			continue;
+
+		target_cpu = cluster_mpidr | (aff0 << MPIDR_AFF0_SHIFT);
+		target_cpu_nodes[MPIDR_AFFLVL0] =
+			psci_get_aff_map_node(target_cpu, MPIDR_AFFLVL0);
+
+		/* Perform generic, architecture & platform specific handling */
+		rc = psci_call_on_handlers(target_cpu_nodes,
+					   MPIDR_AFFLVL0,
+					   end_afflvl,
+					   target_cpu,
+					   entrypoint,
+					   context_id);
+		if (rc != PSCI_E_SUCCESS) {
+			if (ret == PSCI_E_SUCCESS)
+				ret = rc;
+			continue;
+		}
+
+		psci_do_afflvl_state_mgmt(MPIDR_AFFLVL0,
+					  end_afflvl,
+					  target_cpu_nodes,
+					  PSCI_STATE_ON_PENDING);
+		*on_map |= 1UL << aff0;
+	}
+
+	psci_release_afflvl_locks(MPIDR_AFFLVL1,
+				  end_afflvl,
+				  target_cpu_nodes);
+
+	for (aff0 = 0; aff0 < 64; aff0++) {
+		if (!(aff0_map & (1UL << aff0)))
+			continue;
+
+		target_cpu = cluster_mpidr | (aff0 << MPIDR_AFF0_SHIFT);
+		bakery_lock_release(&psci_get_aff_map_node(target_cpu,
+							 MPIDR_AFFLVL0)->lock);
+	}
+
+	return ret;
+}
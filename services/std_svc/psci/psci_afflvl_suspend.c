@@ -146,6 +146,14 @@ static int psci_afflvl0_suspend(aff_map_node_t *cpu_node,
 	/* Set the secure world (EL3) re-entry point after BL1 */
 	psci_entrypoint = (unsigned long) psci_aff_suspend_finish_entry;
 
+#if CTX_LAZY_FPREGS
+	/*
+	 * Generic management: Save the FP/SIMD registers in the context that
+	 * owns them before they lose their contents
+	 */
+	cm_fpregs_flush();
+#endif
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
 	 * cpu caches.
@@ -293,6 +301,72 @@ static int psci_call_suspend_handlers(aff_map_node_t *mpidr_nodes[],
 	return rc;
 }
 
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * In OS-initiated mode, the OS asks for a cluster or the system to be suspended
+ * only from the last cpu running below it. The other cpus below it suspended
+ * themselves at a lower affinity level and still hold their reference on it,
+ * so its reference count does not drop to 0. This function marks the affinity
+ * instances in our mpidr above a cpu as powered off and then checks the view of
+ * the OS against the state of the other cpus. It returns PSCI_E_DENIED and
+ * removes the marks if any of them is running, is powering itself down or up,
+ * or belongs to a lower affinity instance which is not off. It must be called
+ * with the locks of the affinity levels in the range held.
+ ******************************************************************************/
+static int psci_osi_validate_suspend(int start_afflvl,
+				     int end_afflvl,
+				     aff_map_node_t *mpidr_nodes[])
+{
+	aff_map_node_t **cpu_nodes;
+	unsigned int state;
+	int level, cpu;
+
+	for (level = MPIDR_AFFLVL1; level <= end_afflvl; level++)
+		if (mpidr_nodes[level])
+			mpidr_nodes[level]->state |= PSCI_AFF_OSI_OFF;
+
+	/* Pairs with the barrier in psci_osi_get_pwrup_afflvl() */
+	dsb();
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		cpu_nodes = get_cpu_data_by_index(cpu,
+					psci_svc_cpu_data.aff_map_nodes);
+		if (cpu_nodes[MPIDR_AFFLVL0] == NULL ||
+		    cpu_nodes[MPIDR_AFFLVL0] == mpidr_nodes[MPIDR_AFFLVL0] ||
+		    cpu_nodes[end_afflvl] != mpidr_nodes[end_afflvl])
+			continue;
+
+		/*
+		 * The other cpu changes its state and flags without our locks,
+		 * so read them in a single access to check a consistent view.
+		 */
+		state = *(volatile unsigned char *)
+				&cpu_nodes[MPIDR_AFFLVL0]->state;
+		if (state & PSCI_AFF_FLAGS)
+			goto denied;
+
+		state = (state >> PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+		if (state == PSCI_STATE_ON || state == PSCI_STATE_ON_PENDING)
+			goto denied;
+
+		for (level = MPIDR_AFFLVL1; level < end_afflvl; level++)
+			if (cpu_nodes[level] != mpidr_nodes[level] &&
+			    psci_get_phys_state(cpu_nodes[level]) !=
+			    PSCI_STATE_OFF)
+				goto denied;
+	}
+
+	return PSCI_E_SUCCESS;
+
+denied:
+	for (level = MPIDR_AFFLVL1; level <= end_afflvl; level++)
+		if (mpidr_nodes[level])
+			mpidr_nodes[level]->state &= ~PSCI_AFF_OSI_OFF;
+
+	return PSCI_E_DENIED;
+}
+#endif
+
 /*******************************************************************************
  * Top level handler which is called when a cpu wants to suspend its execution.
  * It is assumed that along with turning the cpu off, higher affinity levels
@@ -311,6 +385,9 @@ static int psci_call_suspend_handlers(aff_map_node_t *mpidr_nodes[],
  * the lowest to the highest affinity level implemented by the platform because
  * to turn off affinity level X it is neccesary to turn off affinity level X - 1
  * first.
+ *
+ * In OS-initiated mode, a request to suspend a cluster or the system is denied
+ * unless all the other cpus below it are suspended or off.
  ******************************************************************************/
 int psci_afflvl_suspend(unsigned long entrypoint,
 			unsigned long context_id,
@@ -321,6 +398,7 @@ int psci_afflvl_suspend(unsigned long entrypoint,
 	int rc = PSCI_E_SUCCESS;
 	mpidr_aff_map_nodes_t mpidr_nodes;
 	unsigned int max_phys_off_afflvl;
+	uint32_t locked_afflvls;
 
 	/*
 	 * Collect the pointers to the nodes in the topology tree for
@@ -336,32 +414,58 @@ int psci_afflvl_suspend(unsigned long entrypoint,
 		return rc;
 
 	/*
-	 * This function acquires the lock corresponding to each affinity
-	 * level so that by the time all locks are taken, the system topology
-	 * is snapshot and state management can be done safely.
+	 * Let the other cpus know when this one will be woken up before they
+	 * can see it suspended (see psci_idle_siblings_allow())
 	 */
-	psci_acquire_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
+	psci_idle_record_next_wakeup();
 
 	/*
-	 * This function updates the state of each affinity instance
-	 * corresponding to the mpidr in the range of affinity levels
-	 * specified.
+	 * This function synchronises with the other cpus which change the
+	 * state of the affinity instances in our mpidr, updates the state of
+	 * each affinity instance in the range of affinity levels specified and
+	 * finds the highest affinity level which will be physically powered
+	 * off.
 	 */
-	psci_do_afflvl_state_mgmt(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes,
-				  PSCI_STATE_SUSPEND);
-
-	max_phys_off_afflvl = psci_find_max_phys_off_afflvl(start_afflvl,
-							    end_afflvl,
-							    mpidr_nodes);
+	max_phys_off_afflvl = psci_afflvl_pwrdn_begin(start_afflvl,
+						      end_afflvl,
+						      mpidr_nodes,
+						      PSCI_STATE_SUSPEND,
+						      &locked_afflvls);
 	assert(max_phys_off_afflvl != PSCI_INVALID_DATA);
 
+#if PSCI_OS_INIT_MODE
+	if (end_afflvl > MPIDR_AFFLVL0) {
+		rc = psci_osi_validate_suspend(start_afflvl,
+					       end_afflvl,
+					       mpidr_nodes);
+		if (rc != PSCI_E_SUCCESS) {
+			/* Undo the state changes and let the OS retry */
+			psci_do_afflvl_state_mgmt(start_afflvl,
+						  end_afflvl,
+						  mpidr_nodes,
+						  PSCI_STATE_ON);
+			psci_afflvl_pwrdn_end(start_afflvl,
+					      end_afflvl,
+					      mpidr_nodes,
+					      locked_afflvls);
+			return rc;
+		}
+
+		max_phys_off_afflvl =
+			psci_find_max_phys_off_afflvl(start_afflvl,
+						      end_afflvl,
+						      mpidr_nodes);
+	}
+#endif
+
 	/* Stash the highest affinity level that will be turned off */
 	psci_set_max_phys_off_afflvl(max_phys_off_afflvl);
 
+#if PSCI_STATS
+	/* Timestamp the entry into the power down state */
+	psci_stats_update_pwr_down();
+#endif
+
 	/* Perform generic, architecture and platform specific handling */
 	rc = psci_call_suspend_handlers(mpidr_nodes,
 					start_afflvl,
@@ -379,11 +483,13 @@ int psci_afflvl_suspend(unsigned long entrypoint,
 
 	/*
 	 * Release the locks corresponding to each affinity level in the
-	 * reverse order to which they were acquired.
+	 * reverse order to which they were acquired and let the cpus waiting
+	 * for this cpu to complete its power down operations proceed.
 	 */
-	psci_release_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
+	psci_afflvl_pwrdn_end(start_afflvl,
+			      end_afflvl,
+			      mpidr_nodes,
+			      locked_afflvls);
 
 	return rc;
 }
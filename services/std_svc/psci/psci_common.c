@@ -268,6 +268,330 @@ void psci_release_afflvl_locks(int start_afflvl,
 	}
 }
 
+#if PSCI_LOCKLESS_CPU_STATE
+/*******************************************************************************
+ * The following functions manage the state of the affinity instances in an
+ * mpidr when the cpu powers itself down or up, without taking the lock of each
+ * affinity level. The state of a cpu only changes under the control of that
+ * cpu while it is on, so it is updated without any lock. A cpu which powers
+ * itself down flags its node with PSCI_AFF_PWRDN_PENDING until it is done, and
+ * CPU_ON waits for the flag to be cleared before looking at the state of the
+ * cpu (see psci_get_stable_state()).
+ *
+ * The reference count of a higher affinity level is updated under the count
+ * lock of the node, which is only held for the update itself. It is only
+ * allowed to drop to or rise from 0, i.e. to change the physical state of the
+ * node, with the lock of the node held as well. Hence a cpu only holds the
+ * lock of a higher affinity level when it is the last one to power down or the
+ * first one to power up below it. The last cpu also waits for the other cpus
+ * which dropped their reference without the lock to finish their power down
+ * operations before powering down the node.
+ *
+ * The counters are also updated by cpus with their data cache disabled, so
+ * they are protected by a bakery lock rather than updated with exclusive
+ * accesses, which the platform may not support on this memory.
+ ******************************************************************************/
+
+/*******************************************************************************
+ * This function adds 'delta' to a counter of a node above the cpu level unless
+ * the counter is equal to 'limit'. It returns the new value of the counter or
+ * -1 if it was left unchanged. A 'limit' of -1 is never reached so the
+ * addition always takes place.
+ ******************************************************************************/
+static int psci_count_add_unless(aff_map_node_t *node,
+				 unsigned short *count,
+				 int delta,
+				 int limit)
+{
+	volatile unsigned short *counter = count;
+	int value;
+
+	bakery_lock_get(&node->count_lock);
+	value = *counter;
+	if (value == limit) {
+		value = -1;
+	} else {
+		value = (value + delta) & 0xffff;
+		*counter = value;
+	}
+	bakery_lock_release(&node->count_lock);
+
+	return value;
+}
+
+static void psci_set_cpu_state(aff_map_node_t *cpu_node,
+			       unsigned int state,
+			       unsigned int flags)
+{
+	volatile unsigned char *node_state = &cpu_node->state;
+
+	*node_state = (*node_state & PSCI_AFF_PRESENT) |
+		((state & PSCI_STATE_MASK) << PSCI_STATE_SHIFT) | flags;
+}
+
+/*******************************************************************************
+ * This function updates the state of the affinity instances in an mpidr for
+ * this cpu entering the 'state' (OFF or SUSPEND) and returns the highest
+ * affinity level which will be physically powered off. The affinity levels
+ * whose lock is held on return are set in 'locked_afflvls'.
+ ******************************************************************************/
+uint32_t psci_afflvl_pwrdn_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t state,
+				 uint32_t *locked_afflvls)
+{
+	uint32_t max_phys_off_afflvl = PSCI_INVALID_DATA;
+	aff_map_node_t *node;
+	int level;
+
+	*locked_afflvls = 0;
+	for (level = start_afflvl; level <= end_afflvl; level++) {
+		node = mpidr_nodes[level];
+		if (node == NULL)
+			continue;
+
+		if (level == MPIDR_AFFLVL0) {
+			psci_set_cpu_state(node, state, PSCI_AFF_PWRDN_PENDING);
+			max_phys_off_afflvl = level;
+			continue;
+		}
+
+		/*
+		 * Drop the reference of this cpu without the lock unless it is
+		 * the last one. The node then remains on, so record that this
+		 * cpu is still powering down below it.
+		 */
+		psci_count_add_unless(node, &node->in_transition, 1, -1);
+		if (psci_count_add_unless(node, &node->ref_count, -1, 1) >= 0)
+			continue;
+		psci_count_add_unless(node, &node->in_transition, -1, -1);
+
+		/* This cpu may be the last one. Decide with the lock held */
+		bakery_lock_get(&node->lock);
+		*locked_afflvls |= 1 << level;
+		if (psci_count_add_unless(node, &node->ref_count, -1, -1) != 0)
+			continue;
+
+		/*
+		 * The node will be powered off. Wait for the other cpus below
+		 * it to complete their power down operations first.
+		 */
+		max_phys_off_afflvl = level;
+		while (*(volatile unsigned short *) &node->in_transition)
+			wfe();
+	}
+
+	return max_phys_off_afflvl;
+}
+
+/*******************************************************************************
+ * This function is called once this cpu has completed its power down
+ * operations. It releases the locks taken by psci_afflvl_pwrdn_begin() and
+ * signals the cpus waiting for this cpu to be powered down.
+ ******************************************************************************/
+void psci_afflvl_pwrdn_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls)
+{
+	volatile unsigned char *node_state;
+	aff_map_node_t *node;
+	int level;
+
+	/* Complete the power down operations before letting others proceed */
+	dsb();
+
+	for (level = end_afflvl; level >= start_afflvl; level--) {
+		node = mpidr_nodes[level];
+		if (node == NULL)
+			continue;
+
+		if (level == MPIDR_AFFLVL0) {
+			node_state = &node->state;
+			*node_state &= ~PSCI_AFF_PWRDN_PENDING;
+		} else if (locked_afflvls & (1 << level)) {
+			bakery_lock_release(&node->lock);
+		} else {
+			psci_count_add_unless(node, &node->in_transition, -1, -1);
+		}
+	}
+
+	dsb();
+	sev();
+}
+
+/*******************************************************************************
+ * This function is called when this cpu has been physically powered up. It
+ * takes a reference on the higher affinity levels in an mpidr which are on and
+ * returns the highest affinity level which is physically powered off. The
+ * affinity levels whose lock is held on return are set in 'locked_afflvls'.
+ * Their reference is taken by psci_afflvl_pwrup_end() once they are powered
+ * up.
+ ******************************************************************************/
+uint32_t psci_afflvl_pwrup_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t *locked_afflvls)
+{
+	uint32_t max_phys_off_afflvl = PSCI_INVALID_DATA;
+	aff_map_node_t *node;
+	int level;
+
+	*locked_afflvls = 0;
+	for (level = start_afflvl; level <= end_afflvl; level++) {
+		node = mpidr_nodes[level];
+		if (node == NULL)
+			continue;
+
+		/* The cpu is suspended or about to be turned on i.e. off */
+		if (level == MPIDR_AFFLVL0) {
+			max_phys_off_afflvl = level;
+			continue;
+		}
+
+		/* Take a reference without the lock unless the node is off */
+		if (psci_count_add_unless(node, &node->ref_count, 1, 0) >= 0)
+			continue;
+
+		/* Another cpu may have powered up the node in the meantime */
+		bakery_lock_get(&node->lock);
+		if (psci_count_add_unless(node, &node->ref_count, 1, 0) >= 0) {
+			bakery_lock_release(&node->lock);
+			continue;
+		}
+
+		*locked_afflvls |= 1 << level;
+		max_phys_off_afflvl = level;
+	}
+
+	return max_phys_off_afflvl;
+}
+
+/*******************************************************************************
+ * This function is called once this cpu has completed its power up operations.
+ * It marks the cpu as on, takes a reference on the affinity levels which have
+ * been powered up and releases their lock.
+ ******************************************************************************/
+void psci_afflvl_pwrup_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls)
+{
+	aff_map_node_t *node;
+	int level;
+
+	for (level = end_afflvl; level >= start_afflvl; level--) {
+		node = mpidr_nodes[level];
+		if (node == NULL)
+			continue;
+
+		if (level == MPIDR_AFFLVL0) {
+			psci_set_cpu_state(node, PSCI_STATE_ON, 0);
+		} else if (locked_afflvls & (1 << level)) {
+			psci_count_add_unless(node, &node->ref_count, 1, -1);
+			bakery_lock_release(&node->lock);
+		}
+	}
+}
+
+/*******************************************************************************
+ * This function returns the state of a cpu once it is not powering itself
+ * down anymore. It is used to decide whether a cpu can be turned on. The cpu
+ * may need the locks above the cpu level to complete its power down, so the
+ * caller must not hold any of them.
+ ******************************************************************************/
+unsigned short psci_get_stable_state(aff_map_node_t *node)
+{
+	unsigned char state;
+
+	assert(node->level == MPIDR_AFFLVL0);
+
+	for (;;) {
+		state = *(volatile unsigned char *) &node->state;
+		if (!(state & PSCI_AFF_PWRDN_PENDING))
+			break;
+		wfe();
+	}
+
+	return (state >> PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+}
+#else
+/*******************************************************************************
+ * The following functions manage the state of the affinity instances in an
+ * mpidr when the cpu powers itself down or up. The lock of each affinity
+ * level in the range is held from the beginning to the end of the operation so
+ * that the system topology is snapshot and state management can be done
+ * safely. 'locked_afflvls' is set to the affinity levels in the range.
+ *
+ * In OS-initiated mode, a cpu also flags its node with PSCI_AFF_PWRDN_PENDING
+ * while it powers itself down so that the last cpu of a cluster does not power
+ * the cluster off under its feet (see psci_afflvl_suspend()).
+ ******************************************************************************/
+uint32_t psci_afflvl_pwrdn_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t state,
+				 uint32_t *locked_afflvls)
+{
+	psci_acquire_afflvl_locks(start_afflvl, end_afflvl, mpidr_nodes);
+	*locked_afflvls = (1 << (end_afflvl + 1)) - (1 << start_afflvl);
+
+#if PSCI_OS_INIT_MODE
+	mpidr_nodes[MPIDR_AFFLVL0]->state |= PSCI_AFF_PWRDN_PENDING;
+#endif
+	psci_do_afflvl_state_mgmt(start_afflvl, end_afflvl, mpidr_nodes, state);
+
+	return psci_find_max_phys_off_afflvl(start_afflvl,
+					     end_afflvl,
+					     mpidr_nodes);
+}
+
+void psci_afflvl_pwrdn_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls)
+{
+#if PSCI_OS_INIT_MODE
+	/* Ensure that the power down operations are complete */
+	dsb();
+	mpidr_nodes[MPIDR_AFFLVL0]->state &= ~PSCI_AFF_PWRDN_PENDING;
+#endif
+	psci_release_afflvl_locks(start_afflvl, end_afflvl, mpidr_nodes);
+}
+
+uint32_t psci_afflvl_pwrup_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t *locked_afflvls)
+{
+	psci_acquire_afflvl_locks(start_afflvl, end_afflvl, mpidr_nodes);
+	*locked_afflvls = (1 << (end_afflvl + 1)) - (1 << start_afflvl);
+
+	return psci_find_max_phys_off_afflvl(start_afflvl,
+					     end_afflvl,
+					     mpidr_nodes);
+}
+
+void psci_afflvl_pwrup_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls)
+{
+	psci_do_afflvl_state_mgmt(start_afflvl,
+				  end_afflvl,
+				  mpidr_nodes,
+				  PSCI_STATE_ON);
+
+	psci_release_afflvl_locks(start_afflvl, end_afflvl, mpidr_nodes);
+}
+
+unsigned short psci_get_stable_state(aff_map_node_t *node)
+{
+	return psci_get_state(node);
+}
+#endif /* PSCI_LOCKLESS_CPU_STATE */
+
 /*******************************************************************************
  * Simple routine to determine whether an affinity instance at a given level
  * in an mpidr exists or not.
@@ -354,7 +678,17 @@ unsigned short psci_get_state(aff_map_node_t *node)
 
 	/* A cpu node just contains the state which can be directly returned */
 	if (node->level == MPIDR_AFFLVL0)
-		return (node->state >> PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+		return ((node->state & ~PSCI_AFF_FLAGS) >>
+			PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+
+#if PSCI_OS_INIT_MODE
+	/*
+	 * A node powered off by the last cpu below it in OS-initiated mode is
+	 * off irrespective of the references still held by the other cpus.
+	 */
+	if (node->state & PSCI_AFF_OSI_OFF)
+		return PSCI_STATE_OFF;
+#endif
 
 	/*
 	 * For an affinity level higher than a cpu, the state has to be
@@ -404,7 +738,7 @@ void psci_set_state(aff_map_node_t *node, unsigned short state)
 			assert(0);
 		}
 	} else {
-		node->state &= ~(PSCI_STATE_MASK << PSCI_STATE_SHIFT);
+		node->state &= PSCI_AFF_PRESENT | PSCI_AFF_FLAGS;
 		node->state |= (state & PSCI_STATE_MASK) << PSCI_STATE_SHIFT;
 	}
 }
@@ -456,6 +790,40 @@ static int psci_call_power_on_handlers(aff_map_node_t *mpidr_nodes[],
 	return rc;
 }
 
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * In OS-initiated mode, a cpu which suspended itself at a lower affinity level
+ * than a cluster or the system keeps its reference on it. The last cpu in the
+ * cluster or system could have powered it off in the meantime. This function
+ * flags this cpu as powering up, so that a last cpu which has not powered the
+ * node off yet backs off, and returns the highest affinity level above
+ * 'end_afflvl' in our mpidr which has been powered off this way, or
+ * 'end_afflvl' if there is none.
+ ******************************************************************************/
+static int psci_osi_get_pwrup_afflvl(int end_afflvl)
+{
+	unsigned long mpidr = read_mpidr_el1() & MPIDR_AFFINITY_MASK;
+	aff_map_node_t *node;
+	int level, max_afflvl, pwrup_afflvl = end_afflvl;
+
+	node = psci_get_aff_map_node(mpidr, MPIDR_AFFLVL0);
+	assert(node);
+	node->state |= PSCI_AFF_PWRUP_PENDING;
+
+	/* Pairs with the barrier in psci_osi_validate_suspend() */
+	dsb();
+
+	max_afflvl = get_max_afflvl();
+	for (level = end_afflvl + 1; level <= max_afflvl; level++) {
+		node = psci_get_aff_map_node(mpidr, level);
+		if (node && (node->state & PSCI_AFF_OSI_OFF))
+			pwrup_afflvl = level;
+	}
+
+	return pwrup_afflvl;
+}
+#endif
+
 /*******************************************************************************
  * Generic handler which is called when a cpu is physically powered on. It
  * traverses through all the affinity levels performing generic, architectural,
@@ -471,15 +839,28 @@ static int psci_call_power_on_handlers(aff_map_node_t *mpidr_nodes[],
  * the highest to the lowest affinity level implemented by the platform because
  * to turn on affinity level X it is neccesary to turn on affinity level X + 1
  * first.
+ *
+ * In OS-initiated mode, the affinity levels above 'end_afflvl' which were
+ * powered off by the last cpu below them are powered on as well. Their state
+ * is not changed as this cpu never dropped its reference on them.
  ******************************************************************************/
 void psci_afflvl_power_on_finish(int start_afflvl,
 				 int end_afflvl,
 				 afflvl_power_on_finisher_t *pon_handlers)
 {
 	mpidr_aff_map_nodes_t mpidr_nodes;
-	int rc;
+	int rc, pwrup_afflvl = end_afflvl;
 	unsigned int max_phys_off_afflvl;
+	uint32_t locked_afflvls;
+#if PSCI_STATS
+	uint64_t pwrup_ticks = read_cntpct_el0();
+	int suspend_afflvl = psci_get_suspend_afflvl();
+#endif
+#if PSCI_OS_INIT_MODE
+	int level;
 
+	pwrup_afflvl = psci_osi_get_pwrup_afflvl(end_afflvl);
+#endif
 
 	/*
 	 * Collect the pointers to the nodes in the topology tree for
@@ -489,23 +870,20 @@ void psci_afflvl_power_on_finish(int start_afflvl,
 	 */
 	rc = psci_get_aff_map_nodes(read_mpidr_el1() & MPIDR_AFFINITY_MASK,
 				    start_afflvl,
-				    end_afflvl,
+				    pwrup_afflvl,
 				    mpidr_nodes);
 	if (rc != PSCI_E_SUCCESS)
 		panic();
 
 	/*
-	 * This function acquires the lock corresponding to each affinity
-	 * level so that by the time all locks are taken, the system topology
-	 * is snapshot and state management can be done safely.
+	 * This function synchronises with the other cpus which change the
+	 * state of the affinity instances in our mpidr and finds the highest
+	 * affinity level which is physically powered off.
 	 */
-	psci_acquire_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
-
-	max_phys_off_afflvl = psci_find_max_phys_off_afflvl(start_afflvl,
-							    end_afflvl,
-							    mpidr_nodes);
+	max_phys_off_afflvl = psci_afflvl_pwrup_begin(start_afflvl,
+						      pwrup_afflvl,
+						      mpidr_nodes,
+						      &locked_afflvls);
 	assert(max_phys_off_afflvl != PSCI_INVALID_DATA);
 
 	/*
@@ -517,21 +895,11 @@ void psci_afflvl_power_on_finish(int start_afflvl,
 	/* Perform generic, architecture and platform specific handling */
 	rc = psci_call_power_on_handlers(mpidr_nodes,
 					 start_afflvl,
-					 end_afflvl,
+					 pwrup_afflvl,
 					 pon_handlers);
 	if (rc != PSCI_E_SUCCESS)
 		panic();
 
-	/*
-	 * This function updates the state of each affinity instance
-	 * corresponding to the mpidr in the range of affinity levels
-	 * specified.
-	 */
-	psci_do_afflvl_state_mgmt(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes,
-				  PSCI_STATE_ON);
-
 	/*
 	 * Invalidate the entry for the highest affinity level stashed earlier.
 	 * This ensures that any reads of this variable outside the power
@@ -539,13 +907,39 @@ void psci_afflvl_power_on_finish(int start_afflvl,
 	 */
 	psci_set_max_phys_off_afflvl(PSCI_INVALID_DATA);
 
+#if PSCI_OS_INIT_MODE
 	/*
-	 * This loop releases the lock corresponding to each affinity level
-	 * in the reverse order to which they were acquired.
+	 * The affinity instances in our mpidr are physically on now. Clear the
+	 * marks left by the last cpu which powered them off and release the
+	 * locks of the levels above 'end_afflvl' taken earlier.
 	 */
-	psci_release_afflvl_locks(start_afflvl,
-				  end_afflvl,
-				  mpidr_nodes);
+	for (level = MPIDR_AFFLVL1; level <= pwrup_afflvl; level++)
+		if (mpidr_nodes[level])
+			mpidr_nodes[level]->state &= ~PSCI_AFF_OSI_OFF;
+
+	psci_release_afflvl_locks(end_afflvl + 1, pwrup_afflvl, mpidr_nodes);
+#endif
+
+	/*
+	 * This function updates the state of each affinity instance
+	 * corresponding to the mpidr in the range of affinity levels
+	 * specified and releases the locks taken earlier.
+	 */
+	psci_afflvl_pwrup_end(start_afflvl,
+			      end_afflvl,
+			      mpidr_nodes,
+			      locked_afflvls);
+
+#if PSCI_OS_INIT_MODE
+	/* This cpu is on, the last cpu of the cluster can now see it as such */
+	mpidr_nodes[MPIDR_AFFLVL0]->state &= ~PSCI_AFF_PWRUP_PENDING;
+#endif
+
+#if PSCI_STATS
+	/* Account for the power down state this cpu has been suspended in */
+	if (suspend_afflvl != PSCI_INVALID_DATA)
+		psci_stats_update_pwr_up(suspend_afflvl, pwrup_ticks);
+#endif
 }
 
 /*******************************************************************************
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <psci.h>
+#include <stdint.h>
+#include "psci_private.h"
+
+/*******************************************************************************
+ * Return the offset of the virtual counter of the normal world from the system
+ * counter. Without EL2 there is no offset and CNTVOFF_EL2 must not be accessed.
+ * With EL2, either the hypervisor programs CNTVOFF_EL2 before it runs the
+ * normal world EL1, or BL3-1 clears it when EL2 is not used (see
+ * cm_prepare_el3_exit()).
+ ******************************************************************************/
+static uint64_t psci_idle_get_cntvoff(void)
+{
+	if (!(read_id_aa64pfr0_el1() &
+	      (ID_AA64PFR0_ELX_MASK << ID_AA64PFR0_EL2_SHIFT)))
+		return 0;
+
+	return read_cntvoff_el2();
+}
+
+/*******************************************************************************
+ * Return the system counter value at which the EL1 physical or virtual timer of
+ * this cpu will fire, whichever comes first, or UINT64_MAX if neither of them
+ * is enabled and unmasked.
+ ******************************************************************************/
+static uint64_t psci_idle_get_next_wakeup(void)
+{
+	uint64_t ctl, cval, next_wakeup = UINT64_MAX;
+
+	ctl = read_cntp_ctl_el0();
+	if (get_cntp_ctl_enable(ctl) && !get_cntp_ctl_imask(ctl))
+		next_wakeup = read_cntp_cval_el0();
+
+	/* The virtual timer compares against the offset system counter */
+	ctl = read_cntv_ctl_el0();
+	if (get_cntv_ctl_enable(ctl) && !get_cntv_ctl_imask(ctl)) {
+		cval = read_cntv_cval_el0() + psci_idle_get_cntvoff();
+		if (cval < next_wakeup)
+			next_wakeup = cval;
+	}
+
+	return next_wakeup;
+}
+
+/*******************************************************************************
+ * Record when this cpu will be woken up by its timers from the power down state
+ * it is entering so that other cpus can take it into account when selecting an
+ * idle state for the affinity instances they share with it. This is called
+ * before the state of the cpu is changed, and the barrier orders the record
+ * before the new state for the cpus which observe it.
+ ******************************************************************************/
+void psci_idle_record_next_wakeup(void)
+{
+	if (!psci_plat_pm_ops->get_idle_states)
+		return;
+
+	set_cpu_data(psci_svc_cpu_data.next_wakeup,
+		     psci_idle_get_next_wakeup());
+	dmb();
+}
+
+/* Convert microseconds to ticks of the system counter */
+static uint64_t psci_idle_us_to_ticks(unsigned int us)
+{
+	return (plat_get_syscnt_freq() * us) / 1000000;
+}
+
+/*******************************************************************************
+ * Check whether the affinity instance at 'afflvl' in the mpidr of this cpu can
+ * stay powered off until the system counter reaches 'deadline'. It cannot if
+ * another cpu below it is running or will be woken up by its timers earlier.
+ *
+ * The other cpus are not locked out, so this is only a snapshot. A cpu seen
+ * suspended has recorded its next wake up before changing its state, and the
+ * barrier orders the reads of the state and of the record likewise. A cpu
+ * which wakes up or is turned on afterwards powers the affinity instance up
+ * again through the usual PSCI state coordination; only the choice of the
+ * idle state may then turn out to be too deep.
+ ******************************************************************************/
+static int psci_idle_siblings_allow(unsigned int afflvl, uint64_t deadline)
+{
+	aff_map_node_t *my_cpu_node, *my_node, **cpu_nodes;
+	unsigned int state;
+	int cpu;
+
+	assert(afflvl <= MPIDR_MAX_AFFLVL);
+	my_cpu_node =
+		get_cpu_data(psci_svc_cpu_data.aff_map_nodes[MPIDR_AFFLVL0]);
+	my_node = get_cpu_data(psci_svc_cpu_data.aff_map_nodes[afflvl]);
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		cpu_nodes = get_cpu_data_by_index(cpu,
+					psci_svc_cpu_data.aff_map_nodes);
+		if (cpu_nodes[afflvl] != my_node ||
+		    cpu_nodes[MPIDR_AFFLVL0] == my_cpu_node)
+			continue;
+
+		state = psci_get_state(cpu_nodes[MPIDR_AFFLVL0]);
+		if (state == PSCI_STATE_OFF)
+			continue;
+
+		dmb();
+
+		if (state != PSCI_STATE_SUSPEND ||
+		    get_cpu_data_by_index(cpu, psci_svc_cpu_data.next_wakeup) <
+		    deadline)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*******************************************************************************
+ * Handler for the vendor specific extension of CPU_SUSPEND in which the caller
+ * passes the wake up latency it tolerates, in microseconds, instead of a power
+ * state. It enters the deepest idle state described by the platform which:
+ *   - can be entered and exited within 'latency',
+ *   - has a target residency shorter than the time to the next timer event of
+ *     this cpu,
+ *   - does not power down an affinity instance above the cpu while another cpu
+ *     in it is running or will be woken up by its timers within the target
+ *     residency. A cluster power down state is demoted to the next shallower
+ *     state in the table in this case, e.g. a cpu power down state on FVP and
+ *     Juno which describe no cluster retention state.
+ * If no idle state fits, the cpu just executes a wfi and returns.
+ ******************************************************************************/
+int psci_cpu_suspend_latency(unsigned int latency,
+			     unsigned long entrypoint,
+			     unsigned long context_id)
+{
+	const plat_idle_state_t *states, *state;
+	unsigned int num_states, afflvl;
+	uint64_t now, deadline;
+	int idx;
+
+	if (!psci_plat_pm_ops->get_idle_states)
+		return PSCI_E_NOT_SUPPORTED;
+
+	num_states = psci_plat_pm_ops->get_idle_states(&states);
+	now = read_cntpct_el0();
+
+	for (idx = num_states - 1; idx >= 0; idx--) {
+		state = &states[idx];
+		if (state->entry_latency + state->exit_latency > latency)
+			continue;
+
+		deadline = now + psci_idle_us_to_ticks(state->target_residency);
+		if (psci_idle_get_next_wakeup() < deadline)
+			continue;
+
+		afflvl = psci_get_pstate_afflvl(state->power_state);
+		if (afflvl > MPIDR_AFFLVL0 &&
+		    (psci_get_pstate_type(state->power_state)) ==
+		    PSTATE_TYPE_POWERDOWN &&
+		    !psci_idle_siblings_allow(afflvl, deadline))
+			continue;
+
+		return psci_cpu_suspend(state->power_state,
+					entrypoint,
+					context_id);
+	}
+
+	dsb();
+	wfi();
+
+	return PSCI_E_SUCCESS;
+}
@@ -68,6 +68,45 @@ exit:
 	return rc;
 }
 
+/*******************************************************************************
+ * Vendor specific extension of CPU_ON which turns on the cpus in the cluster
+ * 'cluster_mpidr' whose affinity level 0 values are set in 'aff0_map', with
+ * the same entrypoint and context id. The cpus turned on are set in 'on_map'.
+ ******************************************************************************/
+int psci_cpu_on_batch(unsigned long cluster_mpidr,
+		      uint64_t aff0_map,
+		      unsigned long entrypoint,
+		      unsigned long context_id,
+		      uint64_t *on_map)
+{
+	unsigned long target_cpu;
+	unsigned int aff0;
+
+	*on_map = 0;
+
+	if (aff0_map == 0 || (cluster_mpidr & ~MPIDR_AFFINITY_MASK) ||
+	    (cluster_mpidr & (MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT)))
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Determine if all the cpus exist before turning any of them on */
+	for (aff0 = 0; aff0 < 64; aff0++) {
+		if (!(aff0_map & (1UL << aff0)))
+			continue;
+
+		target_cpu = cluster_mpidr | (aff0 << MPIDR_AFF0_SHIFT);
+		if (psci_validate_mpidr(target_cpu, MPIDR_AFFLVL0) !=
+		    PSCI_E_SUCCESS)
+			return PSCI_E_INVALID_PARAMS;
+	}
+
+	return psci_afflvl_on_batch(cluster_mpidr,
+				    aff0_map,
+				    entrypoint,
+				    context_id,
+				    get_max_afflvl(),
+				    on_map);
+}
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
@@ -92,6 +131,18 @@ int psci_cpu_suspend(unsigned int power_state,
 	/* Determine the 'state type' in the 'power_state' parameter */
 	pstate_type = psci_get_pstate_type(power_state);
 
+	/*
+	 * A cpu power down state which the platform implements as a retention
+	 * state does not lose any context. Enter it like a standby state and
+	 * skip the context save, the cache maintenance and the warm boot path.
+	 */
+	if (pstate_type == PSTATE_TYPE_POWERDOWN &&
+	    target_afflvl == MPIDR_AFFLVL0 &&
+	    psci_plat_pm_ops->affinst_standby &&
+	    psci_plat_pm_ops->affinst_is_retention &&
+	    psci_plat_pm_ops->affinst_is_retention(power_state))
+		pstate_type = PSTATE_TYPE_STANDBY;
+
 	/*
 	 * Ensure that we have a platform specific handler for entering
 	 * a standby state.
@@ -117,7 +168,7 @@ int psci_cpu_suspend(unsigned int power_state,
 				 target_afflvl);
 	if (rc == PSCI_E_SUCCESS)
 		psci_power_down_wfi();
-	assert(rc == PSCI_E_INVALID_PARAMS);
+	assert(rc == PSCI_E_INVALID_PARAMS || rc == PSCI_E_DENIED);
 	return rc;
 }
 
@@ -258,6 +309,14 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 			psci_system_reset();
 			/* We should never return from psci_system_reset() */
 
+#if PSCI_STATS
+		case PSCI_STAT_RESIDENCY_AARCH32:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH32:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
@@ -280,6 +339,14 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_MIG_INFO_UP_CPU_AARCH64:
 			SMC_RET1(handle, psci_migrate_info_up_cpu());
 
+#if PSCI_STATS
+		case PSCI_STAT_RESIDENCY_AARCH64:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH64:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
@@ -288,3 +355,45 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 	WARN("Unimplemented PSCI Call: 0x%x \n", smc_fid);
 	SMC_RET1(handle, SMC_UNK);
 }
+
+#if SMC_LEAF_HANDLERS
+/*******************************************************************************
+ * PSCI leaf SMC handlers. These calls only read PSCI state so they are served
+ * directly from the SMC exception vector without the full context save.
+ ******************************************************************************/
+static uint64_t psci_version_leaf_handler(uint32_t smc_fid,
+					  uint64_t x1,
+					  uint64_t x2,
+					  uint64_t x3,
+					  uint64_t flags)
+{
+	if (is_caller_secure(flags))
+		return SMC_UNK;
+
+	return psci_version();
+}
+
+static uint64_t psci_affinity_info_leaf_handler(uint32_t smc_fid,
+						uint64_t x1,
+						uint64_t x2,
+						uint64_t x3,
+						uint64_t flags)
+{
+	if (is_caller_secure(flags))
+		return SMC_UNK;
+
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		/* 32-bit PSCI function, clear top parameter bits */
+		x1 = (uint32_t)x1;
+		x2 = (uint32_t)x2;
+	}
+
+	return psci_affinity_info(x1, x2);
+}
+
+DECLARE_RT_SVC_LEAF(psci_version, PSCI_VERSION, psci_version_leaf_handler);
+DECLARE_RT_SVC_LEAF(psci_affinity_info_aarch32, PSCI_AFFINITY_INFO_AARCH32,
+		    psci_affinity_info_leaf_handler);
+DECLARE_RT_SVC_LEAF(psci_affinity_info_aarch64, PSCI_AFFINITY_INFO_AARCH64,
+		    psci_affinity_info_leaf_handler);
+#endif
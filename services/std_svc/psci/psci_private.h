@@ -52,9 +52,33 @@ typedef struct aff_map_node {
 	unsigned short ref_count;
 	unsigned char state;
 	unsigned char level;
+#if PSCI_LOCKLESS_CPU_STATE
+	/* Number of cpus below this node which are still powering down */
+	unsigned short in_transition;
+#endif
 	bakery_lock_t lock;
+#if PSCI_LOCKLESS_CPU_STATE
+	/* Protects 'ref_count' and 'in_transition' above the cpu level */
+	bakery_lock_t count_lock;
+#endif
 } aff_map_node_t;
 
+/*
+ * Flags set in the state of a cpu node while the cpu powers itself down when
+ * its state is managed without locks or in OS-initiated mode, and while it
+ * powers itself up in OS-initiated mode. They are never part of the PSCI state.
+ */
+#define PSCI_AFF_PWRUP_PENDING	(1 << 6)
+#define PSCI_AFF_PWRDN_PENDING	(1 << 7)
+#define PSCI_AFF_FLAGS		(PSCI_AFF_PWRUP_PENDING | PSCI_AFF_PWRDN_PENDING)
+
+/*
+ * Flag set in the state of a node above a cpu when it has been powered off by
+ * the last cpu below it in OS-initiated mode while the other cpus still hold a
+ * reference on it.
+ */
+#define PSCI_AFF_OSI_OFF	(1 << 5)
+
 typedef struct aff_limits_node {
 	int min;
 	int max;
@@ -102,6 +126,24 @@ void psci_acquire_afflvl_locks(int start_afflvl,
 void psci_release_afflvl_locks(int start_afflvl,
 				int end_afflvl,
 				mpidr_aff_map_nodes_t mpidr_nodes);
+uint32_t psci_afflvl_pwrdn_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t state,
+				 uint32_t *locked_afflvls);
+void psci_afflvl_pwrdn_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls);
+uint32_t psci_afflvl_pwrup_begin(int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *mpidr_nodes[],
+				 uint32_t *locked_afflvls);
+void psci_afflvl_pwrup_end(int start_afflvl,
+			   int end_afflvl,
+			   aff_map_node_t *mpidr_nodes[],
+			   uint32_t locked_afflvls);
+unsigned short psci_get_stable_state(aff_map_node_t *node);
 void psci_print_affinity_map(void);
 void psci_set_max_phys_off_afflvl(uint32_t afflvl);
 uint32_t psci_find_max_phys_off_afflvl(uint32_t start_afflvl,
@@ -121,6 +163,12 @@ int psci_afflvl_on(unsigned long,
 			unsigned long,
 			int,
 			int);
+int psci_afflvl_on_batch(unsigned long cluster_mpidr,
+			 uint64_t aff0_map,
+			 unsigned long entrypoint,
+			 unsigned long context_id,
+			 int end_afflvl,
+			 uint64_t *on_map);
 
 /* Private exported functions from psci_affinity_off.c */
 int psci_afflvl_off(int, int);
@@ -138,6 +186,20 @@ void psci_set_suspend_power_state(unsigned int power_state);
 void psci_do_pwrdown_cache_maintenance(uint32_t affinity_level);
 void psci_do_pwrup_cache_maintenance(void);
 
+/* Private exported functions from psci_main.c */
+int psci_cpu_suspend(unsigned int power_state,
+		     unsigned long entrypoint,
+		     unsigned long context_id);
+
+/* Private exported functions from psci_idle.c */
+void psci_idle_record_next_wakeup(void);
+
+#if PSCI_STATS
+/* Private exported functions from psci_stat.c */
+void psci_stats_update_pwr_down(void);
+void psci_stats_update_pwr_up(int afflvl, uint64_t pwrup_ticks);
+#endif
+
 /* Private exported functions from psci_system_off.c */
 void __dead2 psci_system_off(void);
 void __dead2 psci_system_reset(void);
@@ -60,8 +60,10 @@ static aff_limits_node_t psci_aff_limits[MPIDR_MAX_AFFLVL + 1];
 /*******************************************************************************
  * Routines for retrieving the node corresponding to an affinity level instance
  * in the mpidr. The first one uses binary search to find the node corresponding
- * to the mpidr (key) at a particular affinity level. The second routine decides
- * extents of the binary search at each affinity level.
+ * to the mpidr (key) at a particular affinity level. The second routine looks
+ * up the node in the per-cpu array of nodes populated by psci_setup() and
+ * falls back to the binary search, within the extents of the affinity level,
+ * if the mpidr does not identify a cpu whose nodes have been populated.
  ******************************************************************************/
 static int psci_aff_map_get_idx(unsigned long key,
 				int min_idx,
@@ -93,8 +95,25 @@ static int psci_aff_map_get_idx(unsigned long key,
 
 aff_map_node_t *psci_get_aff_map_node(unsigned long mpidr, int aff_lvl)
 {
+	aff_map_node_t *node;
+	unsigned int linear_id;
 	int rc;
 
+	assert(aff_lvl >= MPIDR_AFFLVL0 && aff_lvl <= MPIDR_MAX_AFFLVL);
+
+	/*
+	 * Check the node cached for the cpu designated by the mpidr. It only
+	 * matches if the mpidr is valid at the required affinity level.
+	 */
+	linear_id = platform_get_core_pos(mpidr);
+	if (linear_id < PLATFORM_CORE_COUNT) {
+		node = get_cpu_data_by_index(linear_id,
+				psci_svc_cpu_data.aff_map_nodes[aff_lvl]);
+		if (node && node->mpidr ==
+				mpidr_mask_lower_afflvls(mpidr, aff_lvl))
+			return node;
+	}
+
 	/* Right shift the mpidr to the required affinity level */
 	mpidr = mpidr_mask_lower_afflvls(mpidr, aff_lvl);
 
@@ -173,6 +192,10 @@ static void psci_init_aff_map_node(unsigned long mpidr,
 	psci_aff_map[idx].mpidr = mpidr;
 	psci_aff_map[idx].level = level;
 	bakery_lock_init(&psci_aff_map[idx].lock);
+#if PSCI_LOCKLESS_CPU_STATE
+	if (level > MPIDR_AFFLVL0)
+		bakery_lock_init(&psci_aff_map[idx].count_lock);
+#endif
 
 	/*
 	 * If an affinity instance is present then mark it as OFF to begin with.
@@ -219,6 +242,39 @@ static void psci_init_aff_map_node(unsigned long mpidr,
 	return;
 }
 
+/*******************************************************************************
+ * This function caches, in the per-cpu data of each cpu in the affinity map, a
+ * pointer to the node of each affinity instance which contains the cpu. Hot
+ * paths then retrieve the nodes of a cpu by indexing instead of searching the
+ * affinity map. It must be called once the extents of each affinity level in
+ * the map are known. The pointers are flushed as they are read by cpus which
+ * have their data cache disabled in the warm boot path.
+ ******************************************************************************/
+static void psci_init_aff_map_nodes_cache(int max_afflvl)
+{
+	unsigned long mpidr;
+	unsigned int linear_id;
+	int idx, afflvl;
+	psci_cpu_data_t *psci_data;
+
+	for (idx = psci_aff_limits[MPIDR_AFFLVL0].min;
+	     idx <= psci_aff_limits[MPIDR_AFFLVL0].max; idx++) {
+		mpidr = psci_aff_map[idx].mpidr;
+		linear_id = platform_get_core_pos(mpidr);
+		assert(linear_id < PLATFORM_CORE_COUNT);
+
+		psci_data = &_cpu_data_by_index(linear_id)->psci_svc_cpu_data;
+		for (afflvl = MPIDR_AFFLVL0; afflvl <= max_afflvl; afflvl++) {
+			psci_data->aff_map_nodes[afflvl] =
+				psci_get_aff_map_node(mpidr, afflvl);
+			assert(psci_data->aff_map_nodes[afflvl]);
+		}
+
+		flush_dcache_range((uint64_t) psci_data->aff_map_nodes,
+				   sizeof(psci_data->aff_map_nodes));
+	}
+}
+
 /*******************************************************************************
  * Core routine used by the Breadth-First-Search algorithm to populate the
  * affinity tree. Each level in the tree corresponds to an affinity level. This
@@ -337,6 +393,9 @@ int32_t psci_setup(void)
 	flush_dcache_range((unsigned long) psci_aff_limits,
 			   sizeof(psci_aff_limits));
 
+	/* Cache the nodes of each cpu now that the map can be searched */
+	psci_init_aff_map_nodes_cache(max_afflvl);
+
 	/*
 	 * Mark the affinity instances in our mpidr as ON. No need to lock as
 	 * this is the primary cpu.
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <psci.h>
+#include <stddef.h>
+#include "psci_private.h"
+
+/*******************************************************************************
+ * Record the time at which this cpu enters a power down state. This is called
+ * before the caches of the cpu are flushed, so the timestamp is cleaned to
+ * memory as it is read back with the data cache disabled upon power up.
+ ******************************************************************************/
+void psci_stats_update_pwr_down(void)
+{
+	set_cpu_data(psci_stats.pwrdn_timestamp, read_cntpct_el0());
+	flush_cpu_data(psci_stats.pwrdn_timestamp);
+}
+
+/*******************************************************************************
+ * Account for the power down state at affinity level 'afflvl' which this cpu
+ * has just exited. 'pwrup_ticks' is the value of the system counter read when
+ * the cpu entered BL3-1 upon power up. This is called once the data cache is
+ * enabled. Only this cpu updates its statistics so no locking is needed.
+ ******************************************************************************/
+void psci_stats_update_pwr_up(int afflvl, uint64_t pwrup_ticks)
+{
+	psci_stats_t *stats = &get_cpu_data(psci_stats);
+	psci_stat_t *stat;
+
+	assert(afflvl >= MPIDR_AFFLVL0 && afflvl <= MPIDR_MAX_AFFLVL);
+
+	stat = &stats->afflvl[afflvl];
+	stat->count++;
+	stat->residency += pwrup_ticks - stats->pwrdn_timestamp;
+	stat->exit_latency = read_cntpct_el0() - pwrup_ticks;
+}
+
+/*******************************************************************************
+ * Return the statistics of the cpu 'target_cpu' for the power state
+ * 'power_state', or NULL if either of them is invalid. Only power down states
+ * are accounted for.
+ ******************************************************************************/
+static const psci_stat_t *psci_get_stat(unsigned long target_cpu,
+					unsigned int power_state)
+{
+	unsigned int afflvl;
+
+	if (psci_validate_mpidr(target_cpu, MPIDR_AFFLVL0) != PSCI_E_SUCCESS)
+		return NULL;
+
+	if (psci_validate_power_state(power_state))
+		return NULL;
+
+	if ((psci_get_pstate_type(power_state)) != PSTATE_TYPE_POWERDOWN)
+		return NULL;
+
+	afflvl = psci_get_pstate_afflvl(power_state);
+	if (afflvl > MPIDR_MAX_AFFLVL)
+		return NULL;
+
+	return &get_cpu_data_by_mpidr(target_cpu, psci_stats).afflvl[afflvl];
+}
+
+/* Convert ticks of the system counter to microseconds without overflowing */
+static uint64_t psci_stat_ticks_to_us(uint64_t ticks)
+{
+	uint64_t freq = plat_get_syscnt_freq();
+
+	return (ticks / freq) * 1000000 + ((ticks % freq) * 1000000) / freq;
+}
+
+/*******************************************************************************
+ * PSCI_STAT_RESIDENCY: return the time, in microseconds, spent by 'target_cpu'
+ * in 'power_state' since cold boot, or 0 if the parameters are invalid.
+ ******************************************************************************/
+uint64_t psci_stat_residency(unsigned long target_cpu,
+			     unsigned int power_state)
+{
+	const psci_stat_t *stat;
+
+	stat = psci_get_stat(target_cpu, power_state);
+	if (stat == NULL)
+		return 0;
+
+	return psci_stat_ticks_to_us(stat->residency);
+}
+
+/*******************************************************************************
+ * PSCI_STAT_COUNT: return the number of times 'target_cpu' has entered
+ * 'power_state' since cold boot, or 0 if the parameters are invalid.
+ ******************************************************************************/
+uint64_t psci_stat_count(unsigned long target_cpu, unsigned int power_state)
+{
+	const psci_stat_t *stat;
+
+	stat = psci_get_stat(target_cpu, power_state);
+	if (stat == NULL)
+		return 0;
+
+	return stat->count;
+}
+
+/*******************************************************************************
+ * Return the time, in microseconds, taken by the last power up sequence in
+ * BL3-1 of 'target_cpu' from 'power_state', or 0 if the parameters are invalid.
+ * This is not part of PSCI, it is served by the generic SiP Service.
+ ******************************************************************************/
+uint64_t psci_stat_exit_latency(unsigned long target_cpu,
+				unsigned int power_state)
+{
+	const psci_stat_t *stat;
+
+	stat = psci_get_stat(target_cpu, power_state);
+	if (stat == NULL)
+		return 0;
+
+	return psci_stat_ticks_to_us(stat->exit_latency);
+}
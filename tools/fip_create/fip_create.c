@@ -37,11 +37,13 @@
 #include <sys/stat.h>
 #include "fip_create.h"
 #include "firmware_image_package.h"
+#include "lz4_compress.h"
 
 /* Values returned by getopt() as part of the command line parsing */
 #define OPT_TOC_ENTRY 0
 #define OPT_DUMP 1
 #define OPT_HELP 2
+#define OPT_COMPRESS 3
 
 file_info_t files[MAX_FILES];
 unsigned file_info_count = 0;
@@ -90,7 +92,8 @@ static void print_usage(void)
 	printf("\tThis tool is used to create a Firmware Image Package.\n\n");
 	printf("Options:\n");
 	printf("\t--help: Print this help message and exit\n");
-	printf("\t--dump: Print contents of FIP\n\n");
+	printf("\t--dump: Print contents of FIP\n");
+	printf("\t--compress NAME: Compress the component NAME, e.g. bl33\n\n");
 	printf("\tComponents that can be added/updated:\n");
 	for (; entry->command_line_name != NULL; entry++) {
 		printf("\t--%s%s\t\t%s",
@@ -163,6 +166,7 @@ static int add_file_info_entry(entry_lookup_list_t *lookup_entry, char *filename
 	file_info_entry->filename = filename;
 	file_info_entry->size = (unsigned int)file_status.st_size;
 	file_info_entry->entry = lookup_entry;
+	file_info_entry->toc_flags = 0;
 
 	/* Increment the file_info counter on success if it is new file entry */
 	if (is_new_entry) {
@@ -317,7 +321,7 @@ static int pack_images(const char *fip_filename)
 		copy_uuid(&toc_entry->uuid, &files[entry_index].name_uuid);
 		toc_entry->offset_address = entry_offset_address;
 		toc_entry->size = files[entry_index].size;
-		toc_entry->flags = 0;
+		toc_entry->flags = files[entry_index].toc_flags;
 		entry_offset_address += toc_entry->size;
 		toc_entry++;
 	}
@@ -358,7 +362,9 @@ static void dump_toc(void)
 		}
 		image_size = files[index].size;
 
-		printf("offset=0x%X, size=0x%X\n", image_offset, image_size);
+		printf("offset=0x%X, size=0x%X%s\n", image_offset, image_size,
+		       (files[index].toc_flags & TOC_ENTRY_FLAG_LZ4) ?
+		       ", lz4" : "");
 		image_offset += image_size;
 
 		if (files[index].filename) {
@@ -451,6 +457,7 @@ static int parse_fip(const char *fip_filename)
 		file_info_entry->image_buffer = fip_buffer +
 		  toc_entry->offset_address;
 		file_info_entry->size = toc_entry->size;
+		file_info_entry->toc_flags = toc_entry->flags;
 
 		/* Check if there is a corresponding entry in lookup table */
 		file_info_entry->entry =
@@ -485,6 +492,72 @@ static int parse_fip(const char *fip_filename)
 }
 
 
+/* Replace the image of a file_info entry by its compressed form */
+static int compress_file(file_info_t *info)
+{
+	fip_lz4_header_t *header;
+	uint8_t *image;
+	uint8_t *buffer;
+	size_t size;
+	int status;
+
+	image = malloc(info->size);
+	buffer = malloc(sizeof(*header) + LZ4_COMPRESS_BOUND(info->size));
+	if ((image == NULL) || (buffer == NULL)) {
+		printf("ERROR: Cannot allocate memory to compress image.\n");
+		free(image);
+		free(buffer);
+		return ENOMEM;
+	}
+
+	status = read_file_to_memory(image, info);
+	if (status != 0) {
+		free(image);
+		free(buffer);
+		return status;
+	}
+
+	header = (fip_lz4_header_t *)buffer;
+	header->name = LZ4_HEADER_NAME;
+	header->reserved = 0;
+	header->decoded_size = info->size;
+	size = lz4_compress_block(image, info->size, buffer + sizeof(*header));
+	free(image);
+
+	/* The compressed image now lives in memory only */
+	info->filename = NULL;
+	info->image_buffer = buffer;
+	info->size = (unsigned int)(sizeof(*header) + size);
+	info->toc_flags |= TOC_ENTRY_FLAG_LZ4;
+
+	return 0;
+}
+
+
+/* Compress the images that were selected with '--compress' */
+static int compress_images(void)
+{
+	unsigned int index;
+	int status;
+
+	for (index = 0; index < file_info_count; index++) {
+		if ((files[index].entry == NULL) ||
+		    !(files[index].entry->flags & FLAG_COMPRESS) ||
+		    (files[index].toc_flags & TOC_ENTRY_FLAG_LZ4))
+			continue;
+
+		status = compress_file(&files[index]);
+		if (status != 0) {
+			printf("Failed to compress %s\n",
+			       files[index].entry->name);
+			return status;
+		}
+	}
+
+	return 0;
+}
+
+
 /* Parse all command-line options and return the FIP name if present. */
 static char *get_filename(int argc, char **argv, struct option *options)
 {
@@ -556,6 +629,24 @@ static int parse_cmdline(int argc, char **argv, struct option *options,
 			do_dump = 1;
 			continue;
 
+		case OPT_COMPRESS:
+			for (lookup_entry = toc_entry_lookup_list;
+			     lookup_entry->command_line_name != NULL;
+			     lookup_entry++) {
+				if (strcmp(lookup_entry->command_line_name,
+					   optarg) == 0)
+					break;
+			}
+			if (lookup_entry->command_line_name == NULL) {
+				printf("ERROR: Unknown component \"%s\"\n",
+				       optarg);
+				status = EINVAL;
+				break;
+			}
+			lookup_entry->flags |= FLAG_COMPRESS;
+			*do_pack = 1;
+			continue;
+
 		case OPT_HELP:
 			print_usage();
 			exit(0);
@@ -567,6 +658,10 @@ static int parse_cmdline(int argc, char **argv, struct option *options,
 	}
 
 
+	/* Compress the selected images now so that the dump shows them */
+	if (status == 0)
+		status = compress_images();
+
 	/* Do not dump toc if we have an error as it could hide the error */
 	if ((status == 0) && (do_dump)) {
 		dump_toc();
@@ -588,18 +683,18 @@ int main(int argc, char **argv)
 
 	/* Initialise for getopt_long().
 	 * Use image table as defined at top of file to get options.
-	 * Add 'dump' option, 'help' option and end marker.
+	 * Add 'dump' option, 'help' option, 'compress' option and end marker.
 	 */
 	static struct option long_options[(sizeof(toc_entry_lookup_list)/
-					   sizeof(entry_lookup_list_t)) + 2];
+					   sizeof(entry_lookup_list_t)) + 3];
 
 	for (i = 0;
 	     /* -1 because we dont want to process end marker in toc table */
 	     i < sizeof(toc_entry_lookup_list)/sizeof(entry_lookup_list_t) - 1;
 	     i++) {
 		long_options[i].name = toc_entry_lookup_list[i].command_line_name;
-		/* The only flag defined at the moment is for a FILENAME */
-		long_options[i].has_arg = toc_entry_lookup_list[i].flags ? 1 : 0;
+		long_options[i].has_arg =
+			(toc_entry_lookup_list[i].flags & FLAG_FILENAME) ? 1 : 0;
 		long_options[i].flag = 0;
 		long_options[i].val = OPT_TOC_ENTRY;
 	}
@@ -616,6 +711,12 @@ int main(int argc, char **argv)
 	long_options[i].flag = 0;
 	long_options[i].val = OPT_HELP;
 
+	/* Add '--compress' option */
+	long_options[++i].name = "compress";
+	long_options[i].has_arg = 1;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_COMPRESS;
+
 	/* Zero the last entry (required) */
 	long_options[++i].name = 0;
 	long_options[i].has_arg = 0;
@@ -40,6 +40,7 @@
 #define TOC_HEADER_SERIAL_NUMBER	0x12345678
 
 #define FLAG_FILENAME			(1 << 0)
+#define FLAG_COMPRESS			(1 << 1)
 
 typedef struct entry_lookup_list {
 	const char		*name;
@@ -55,6 +56,7 @@ typedef struct file_info {
 	unsigned int		 size;
 	void			*image_buffer;
 	entry_lookup_list_t	*entry;
+	uint64_t		 toc_flags;
 } file_info_t;
 
 #endif /* __FIP_CREATE_H__ */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include "lz4_compress.h"
+
+/* Parameters of the LZ4 block format */
+#define MIN_MATCH	4	/* Shortest match that can be encoded */
+#define MAX_OFFSET	65535	/* Furthest back a match can refer to */
+#define LAST_LITERALS	5	/* The block must end with this many literals */
+#define MF_LIMIT	12	/* No match may start this close to the end */
+
+#define HASH_LOG	16
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline unsigned int hash32(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - HASH_LOG);
+}
+
+/* Write the extension bytes of a length field that did not fit a token */
+static uint8_t *write_length(uint8_t *op, size_t length)
+{
+	for (; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = (uint8_t)length;
+
+	return op;
+}
+
+/* Write a sequence of literals, optionally followed by a match */
+static uint8_t *write_sequence(uint8_t *op, const uint8_t *literals,
+			       size_t literal_length, size_t offset,
+			       size_t match_length)
+{
+	uint8_t *token = op++;
+
+	*token = (literal_length < 15) ? (literal_length << 4) : (15 << 4);
+	if (literal_length >= 15)
+		op = write_length(op, literal_length - 15);
+	memcpy(op, literals, literal_length);
+	op += literal_length;
+
+	if (match_length == 0)
+		return op;
+
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+	match_length -= MIN_MATCH;
+	*token |= (match_length < 15) ? match_length : 15;
+	if (match_length >= 15)
+		op = write_length(op, match_length - 15);
+
+	return op;
+}
+
+/*
+ * Compress 'src' as a single LZ4 block into 'dst', which must hold at least
+ * LZ4_COMPRESS_BOUND(src_size) bytes. Matches are found greedily through a
+ * hash table of the last position of each 4-byte sequence. Returns the size
+ * of the compressed block.
+ */
+size_t lz4_compress_block(const uint8_t *src, size_t src_size, uint8_t *dst)
+{
+	static long table[1 << HASH_LOG];
+	size_t ip = 0, anchor = 0, length;
+	unsigned int h;
+	long ref;
+	uint8_t *op = dst;
+
+	memset(table, 0xff, sizeof(table));
+
+	while (ip + MF_LIMIT < src_size) {
+		h = hash32(read32(src + ip));
+		ref = table[h];
+		table[h] = (long)ip;
+
+		if ((ref < 0) || (ip - ref > MAX_OFFSET) ||
+		    (read32(src + ref) != read32(src + ip))) {
+			ip++;
+			continue;
+		}
+
+		length = MIN_MATCH;
+		while ((ip + length < src_size - LAST_LITERALS) &&
+		       (src[ref + length] == src[ip + length]))
+			length++;
+
+		op = write_sequence(op, src + anchor, ip - anchor, ip - ref,
+				    length);
+		ip += length;
+		anchor = ip;
+	}
+
+	/* The remaining bytes are emitted as literals */
+	op = write_sequence(op, src + anchor, src_size - anchor, 0, 0);
+
+	return op - dst;
+}
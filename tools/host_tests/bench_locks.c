@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures the cost of acquiring a lock when every cpu of the platform
+ * contends for it. Each cpu is a host thread which repeatedly takes the lock,
+ * increments a shared counter and releases the lock. The counter then tells
+ * whether the lock provided mutual exclusion.
+ *
+ * The ticket lock and the spinlock are the two locks the TSP can protect its
+ * console with (see USE_TICKET_LOCKS). They are host versions of
+ * lib/locks/exclusive/ticket_lock.S and spinlock.S with the same memory
+ * layout and algorithm. The bakery lock is the one BL3-1 uses with
+ * PERCPU_BAKERY_LOCKS=1 and is built from the firmware sources.
+ *
+ * The program is built once per cpu count, from PLATFORM_CLUSTER_COUNT.
+ */
+
+#include <arch_helpers.h>
+#include <bakery_lock.h>
+#include <platform_def.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include "host_support.h"
+
+/*
+ * A bakery ticket is one more than the highest ticket held when it is taken,
+ * so it can grow up to the total number of acquisitions while the lock is
+ * never free. Keep that below the 15-bit limit of the per-cpu bakery tickets.
+ */
+#define ITERATIONS	(16384 / PLATFORM_CORE_COUNT)
+
+/* Next ticket in bits [31:16], ticket being served in bits [15:0] */
+typedef struct host_ticket_lock {
+	volatile uint32_t lock;
+} host_ticket_lock_t;
+
+typedef struct host_spinlock {
+	volatile uint32_t lock;
+} host_spinlock_t;
+
+typedef struct lock_ops {
+	const char *name;
+	void (*get)(void);
+	void (*release)(void);
+} lock_ops_t;
+
+static host_ticket_lock_t ticket;
+static host_spinlock_t spinlock;
+static bakery_lock_t bakery;
+
+static volatile unsigned int start;
+static unsigned long counter;
+static uint64_t max_wait_ns[PLATFORM_CORE_COUNT];
+
+
+static void ticket_get(void)
+{
+	uint32_t t = __atomic_fetch_add(&ticket.lock, 1 << 16,
+					__ATOMIC_ACQUIRE) >> 16;
+
+	while ((__atomic_load_n(&ticket.lock, __ATOMIC_ACQUIRE) & 0xffff) != t)
+		wfe();
+}
+
+static void ticket_release(void)
+{
+	/* Only the owner updates the ticket being served */
+	uint16_t *serving = (uint16_t *)&ticket.lock;
+
+	__atomic_store_n(serving, *serving + 1, __ATOMIC_RELEASE);
+	sev();
+}
+
+static void spin_get(void)
+{
+	while (__atomic_exchange_n(&spinlock.lock, 1, __ATOMIC_ACQUIRE))
+		while (spinlock.lock)
+			wfe();
+}
+
+static void spin_release(void)
+{
+	__atomic_store_n(&spinlock.lock, 0, __ATOMIC_RELEASE);
+}
+
+static void bakery_get(void)
+{
+	bakery_lock_get(&bakery);
+}
+
+static void bakery_release(void)
+{
+	bakery_lock_release(&bakery);
+}
+
+static const lock_ops_t locks[] = {
+	{ "ticket", ticket_get, ticket_release },
+	{ "spinlock", spin_get, spin_release },
+	{ "bakery", bakery_get, bakery_release },
+};
+
+static const lock_ops_t *cur_lock;
+
+
+static void *cpu_main(void *arg)
+{
+	unsigned int cpu = (uintptr_t)arg;
+	uint64_t t, wait;
+	int i;
+
+	host_set_cpu(cpu);
+	while (!start)
+		sched_yield();
+
+	for (i = 0; i < ITERATIONS; i++) {
+		t = host_time_ns();
+		cur_lock->get();
+		wait = host_time_ns() - t;
+		if (wait > max_wait_ns[cpu])
+			max_wait_ns[cpu] = wait;
+		counter++;
+		cur_lock->release();
+	}
+
+	return NULL;
+}
+
+static void run(const lock_ops_t *lock)
+{
+	pthread_t threads[PLATFORM_CORE_COUNT];
+	uint64_t t, max_wait = 0;
+	unsigned int cpu;
+
+	cur_lock = lock;
+	counter = 0;
+	start = 0;
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		max_wait_ns[cpu] = 0;
+		CHECK(pthread_create(&threads[cpu], NULL, cpu_main,
+				     (void *)(uintptr_t)cpu) == 0);
+	}
+
+	t = host_time_ns();
+	start = 1;
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		pthread_join(threads[cpu], NULL);
+	t = host_time_ns() - t;
+
+	CHECK(counter == (unsigned long)PLATFORM_CORE_COUNT * ITERATIONS);
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		if (max_wait_ns[cpu] > max_wait)
+			max_wait = max_wait_ns[cpu];
+
+	printf("  %-8s %3u cpus: %8llu ns/acquire, max wait %10llu ns\n",
+	       lock->name, PLATFORM_CORE_COUNT,
+	       (unsigned long long)(t / counter),
+	       (unsigned long long)max_wait);
+}
+
+int main(void)
+{
+	unsigned int i;
+
+	host_set_cpu(0);
+	bakery_lock_init(&bakery);
+
+	for (i = 0; i < sizeof(locks) / sizeof(locks[0]); i++)
+		run(&locks[i]);
+
+	return host_test_result("bench_locks");
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures the throughput of the firmware's memory functions against the byte
+ * at a time implementations they replaced, for a range of lengths and for
+ * source and destination buffers that are word aligned, mutually aligned at
+ * an odd address, or not mutually aligned.
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "mem_ref.h"
+
+#define MAX_LENGTH	65536
+#define BYTES_PER_CASE	(64 * 1024 * 1024)
+
+static const size_t lengths[] = { 16, 64, 256, 4096, MAX_LENGTH };
+
+static const struct {
+	const char *name;
+	unsigned int src, dst;
+} alignments[] = {
+	{ "aligned", 0, 0 },
+	{ "odd", 3, 3 },
+	{ "unaligned", 0, 3 },
+};
+
+enum { MEMSET, MEMCMP, MEMCPY, MEMMOVE, NUM_FUNCS };
+
+static const char *func_names[] = { "memset", "memcmp", "memcpy", "memmove" };
+
+static unsigned char src_buf[MAX_LENGTH + 32], dst_buf[MAX_LENGTH + 32];
+
+
+/* Run one function over a buffer enough times to move BYTES_PER_CASE */
+static uint64_t run(unsigned int func, int ref, unsigned char *dst,
+		    const unsigned char *src, size_t len)
+{
+	unsigned long i, rounds = BYTES_PER_CASE / len;
+	uint64_t t = host_time_ns();
+	volatile int sink = 0;
+
+	for (i = 0; i < rounds; i++) {
+		switch (func) {
+		case MEMSET:
+			ref ? memset_ref(dst, 0x5a, len) :
+				memset(dst, 0x5a, len);
+			break;
+		case MEMCMP:
+			sink += ref ? memcmp_ref(dst, src, len) :
+				memcmp(dst, src, len);
+			break;
+		case MEMCPY:
+			ref ? memcpy_ref(dst, src, len) : memcpy(dst, src, len);
+			break;
+		default:
+			/* Overlapping, so that the copy is done backwards */
+			ref ? memmove_ref(dst, src, len) :
+				memmove(dst, src, len);
+			break;
+		}
+
+		/* Keep the compiler from merging or dropping the calls */
+		__asm__ volatile("" : : : "memory");
+	}
+	(void)sink;
+
+	return host_time_ns() - t;
+}
+
+int main(void)
+{
+	unsigned int func, a, l;
+	unsigned char *src, *dst;
+	uint64_t fw_ns, ref_ns;
+
+	for (func = 0; func < NUM_FUNCS; func++) {
+		for (a = 0; a < sizeof(alignments) / sizeof(alignments[0]);
+		     a++) {
+			src = &src_buf[alignments[a].src];
+			dst = &dst_buf[alignments[a].dst];
+
+			/* memmove() copies a buffer a little further into it */
+			if (func == MEMMOVE) {
+				src = &dst_buf[alignments[a].src];
+				dst = &dst_buf[alignments[a].dst + 16];
+			}
+
+			/* memcmp() goes through equal buffers */
+			memset_ref(src_buf, 0x5a, sizeof(src_buf));
+			memset_ref(dst_buf, 0x5a, sizeof(dst_buf));
+
+			for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]);
+			     l++) {
+				fw_ns = run(func, 0, dst, src, lengths[l]);
+				ref_ns = run(func, 1, dst, src, lengths[l]);
+				printf("  %-7s %-9s %6zu bytes: %5llu MB/s, "
+				       "byte loop %5llu MB/s\n",
+				       func_names[func], alignments[a].name,
+				       lengths[l],
+				       (unsigned long long)(BYTES_PER_CASE *
+							    1000ULL / fw_ns),
+				       (unsigned long long)(BYTES_PER_CASE *
+							    1000ULL / ref_ns));
+			}
+		}
+	}
+
+	return 0;
+}
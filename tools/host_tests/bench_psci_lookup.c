@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures the cost of retrieving the affinity map nodes of a cpu in PSCI.
+ * psci_setup() from the firmware builds the affinity map of a platform with
+ * PLATFORM_CLUSTER_COUNT clusters and caches the nodes of each cpu in its
+ * per-cpu data. The lookups of every cpu are timed with that cache, then
+ * with the cache emptied so that psci_get_aff_map_node() falls back to the
+ * binary search of the map, and both must return the same nodes.
+ *
+ * The program is built once per cpu count, from PLATFORM_CLUSTER_COUNT.
+ */
+
+#include <arch_helpers.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <string.h>
+#include "../../services/std_svc/psci/psci_private.h"
+#include "host_support.h"
+
+#define ROUNDS		200
+
+/*******************************************************************************
+ * The parts of psci_common.c, of the platform port and of BL3-1 which
+ * psci_setup() relies on. A platform with two affinity levels is modelled.
+ ******************************************************************************/
+aff_map_node_t psci_aff_map[PSCI_NUM_AFFS];
+const plat_pm_ops_t *psci_plat_pm_ops;
+
+static const plat_pm_ops_t host_pm_ops;
+static cpu_data_t host_cpu_data[PLATFORM_CORE_COUNT];
+
+int get_max_afflvl(void)
+{
+	return MPIDR_AFFLVL1;
+}
+
+unsigned long mpidr_set_aff_inst(unsigned long mpidr,
+				 unsigned char aff_inst,
+				 int aff_lvl)
+{
+	unsigned long aff_shift = aff_lvl * MPIDR_AFFINITY_BITS;
+
+	mpidr &= ~(MPIDR_AFFLVL_MASK << aff_shift);
+	return mpidr | ((unsigned long)aff_inst << aff_shift);
+}
+
+int psci_check_afflvl_range(int start_afflvl, int end_afflvl)
+{
+	if (end_afflvl > MPIDR_MAX_AFFLVL || start_afflvl < MPIDR_AFFLVL0 ||
+	    end_afflvl < start_afflvl)
+		return PSCI_E_INVALID_PARAMS;
+
+	return PSCI_E_SUCCESS;
+}
+
+void psci_set_state(aff_map_node_t *node, unsigned short state)
+{
+	if (node->level == MPIDR_AFFLVL0) {
+		node->state &= PSCI_AFF_PRESENT | PSCI_AFF_FLAGS;
+		node->state |= (state & PSCI_STATE_MASK) << PSCI_STATE_SHIFT;
+	} else if (state == PSCI_STATE_ON) {
+		node->ref_count++;
+	}
+}
+
+unsigned int plat_get_aff_count(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return aff_lvl == MPIDR_AFFLVL1 ? PLATFORM_CLUSTER_COUNT :
+		aff_lvl == MPIDR_AFFLVL0 ? PLATFORM_MAX_CPUS_PER_CLUSTER : 1;
+}
+
+unsigned int plat_get_aff_state(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return PSCI_AFF_PRESENT;
+}
+
+int platform_setup_pm(const plat_pm_ops_t **plat_ops)
+{
+	*plat_ops = &host_pm_ops;
+	return 0;
+}
+
+void cm_set_context_by_mpidr(uint64_t mpidr, void *context,
+			     uint32_t security_state)
+{
+}
+
+cpu_data_t *_cpu_data_by_index(uint32_t cpu_index)
+{
+	return &host_cpu_data[cpu_index];
+}
+
+/******************************************************************************/
+
+static aff_map_node_t *cached[PLATFORM_CORE_COUNT][MPIDR_AFFLVL1 + 1];
+
+/* Look up the node of every cpu at every level, ROUNDS times */
+static uint64_t time_lookups(int check)
+{
+	aff_map_node_t *node;
+	unsigned int cpu, round;
+	uint64_t t;
+	int afflvl;
+
+	t = host_time_ns();
+	for (round = 0; round < ROUNDS; round++) {
+		for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+			for (afflvl = MPIDR_AFFLVL0; afflvl <= MPIDR_AFFLVL1;
+			     afflvl++) {
+				node = psci_get_aff_map_node(
+						host_cpu_mpidr(cpu), afflvl);
+				if (check)
+					CHECK(node == cached[cpu][afflvl]);
+				else
+					cached[cpu][afflvl] = node;
+			}
+		}
+	}
+
+	return (host_time_ns() - t) /
+		(ROUNDS * PLATFORM_CORE_COUNT * (MPIDR_AFFLVL1 + 1));
+}
+
+int main(void)
+{
+	aff_map_node_t *nodes[MPIDR_MAX_AFFLVL + 1];
+	uint64_t cached_ns, search_ns;
+	psci_cpu_data_t *psci_data;
+	unsigned int cpu;
+
+	host_set_cpu(0);
+	CHECK(psci_setup() == 0);
+
+	/* The nodes of each cpu have been cached and are consistent */
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		CHECK(psci_get_aff_map_nodes(host_cpu_mpidr(cpu),
+					     MPIDR_AFFLVL0, MPIDR_AFFLVL1,
+					     nodes) == PSCI_E_SUCCESS);
+		CHECK(nodes[MPIDR_AFFLVL0]->mpidr == host_cpu_mpidr(cpu));
+		CHECK(nodes[MPIDR_AFFLVL1]->mpidr ==
+		      (host_cpu_mpidr(cpu) & MPIDR_CLUSTER_MASK));
+		CHECK(nodes[MPIDR_AFFLVL0] == get_cpu_data_by_index(cpu,
+			psci_svc_cpu_data.aff_map_nodes[MPIDR_AFFLVL0]));
+	}
+
+	/* An mpidr beyond the topology is still rejected */
+	CHECK(psci_get_aff_map_node(host_cpu_mpidr(PLATFORM_CORE_COUNT),
+				    MPIDR_AFFLVL1) == NULL);
+
+	cached_ns = time_lookups(0);
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		psci_data = &host_cpu_data[cpu].psci_svc_cpu_data;
+		memset(psci_data->aff_map_nodes, 0,
+		       sizeof(psci_data->aff_map_nodes));
+	}
+
+	search_ns = time_lookups(1);
+
+	printf("  %3u cpus: %4llu ns/lookup cached, %4llu ns/lookup searched\n",
+	       PLATFORM_CORE_COUNT, (unsigned long long)cached_ns,
+	       (unsigned long long)search_ns);
+
+	return host_test_result("bench_psci_lookup");
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "host_support.h"
+
+__thread uint64_t host_mpidr_el1;
+__thread uint64_t host_tpidr_el3;
+__thread uint64_t host_sctlr_el3 = SCTLR_C_BIT;
+uint64_t host_id_aa64isar0_el1;
+uint64_t host_id_aa64pfr0_el1;
+__thread uint64_t host_cntpct_el0;
+__thread uint64_t host_cntp_ctl_el0, host_cntp_cval_el0;
+__thread uint64_t host_cntv_ctl_el0, host_cntv_cval_el0;
+__thread uint64_t host_cntvoff_el2;
+void (*host_flush_dcache_range_hook)(uint64_t addr, uint64_t size);
+
+static unsigned int check_failures;
+
+
+void host_check_failed(const char *file, int line, const char *cond)
+{
+	printf("%s:%d: check failed: %s\n", file, line, cond);
+	__sync_fetch_and_add(&check_failures, 1);
+}
+
+int host_test_result(const char *name)
+{
+	if (check_failures) {
+		printf("%s: FAILED (%u checks)\n", name, check_failures);
+		return 1;
+	}
+
+	printf("%s: PASSED\n", name);
+	return 0;
+}
+
+uint64_t host_cpu_mpidr(unsigned int cpu_index)
+{
+	return ((cpu_index / PLATFORM_MAX_CPUS_PER_CLUSTER) <<
+		MPIDR_AFF1_SHIFT) |
+		(cpu_index % PLATFORM_MAX_CPUS_PER_CLUSTER);
+}
+
+void host_set_cpu(unsigned int cpu_index)
+{
+	host_mpidr_el1 = host_cpu_mpidr(cpu_index);
+}
+
+uint64_t host_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/*******************************************************************************
+ * Firmware services used by the code under test
+ ******************************************************************************/
+unsigned int platform_get_core_pos(unsigned long mpidr)
+{
+	return ((mpidr >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK) *
+		PLATFORM_MAX_CPUS_PER_CLUSTER + (mpidr & MPIDR_AFFLVL_MASK);
+}
+
+/* As in lib/locks/exclusive/spinlock.S */
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1, __ATOMIC_ACQUIRE))
+		while (lock->lock)
+			wfe();
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void do_panic(void)
+{
+	printf("PANIC\n");
+	abort();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __HOST_SUPPORT_H__
+#define __HOST_SUPPORT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Helpers shared by the host tests. A test exercises firmware sources built
+ * for the host against the stub headers in include/. Each host thread can
+ * play the part of a cpu, in which case it must call host_set_cpu() first.
+ */
+
+/* Report a failed check and carry on; main() returns host_test_result() */
+#define CHECK(cond)	do {						\
+	if (!(cond))							\
+		host_check_failed(__FILE__, __LINE__, #cond);		\
+} while (0)
+
+void host_check_failed(const char *file, int line, const char *cond);
+int host_test_result(const char *name);
+
+/* Make the calling thread run as the cpu with a given linear index */
+void host_set_cpu(unsigned int cpu_index);
+uint64_t host_cpu_mpidr(unsigned int cpu_index);
+
+/* Monotonic time in nanoseconds */
+uint64_t host_time_ns(void);
+
+#endif /* __HOST_SUPPORT_H__ */
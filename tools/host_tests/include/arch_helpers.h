@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+/*
+ * Host replacement for include/lib/aarch64/arch_helpers.h. Barriers become
+ * full memory barriers, waiting for an event yields to the other host
+ * threads and cache maintenance does nothing as the host is coherent, other
+ * than reporting the flushed ranges to host_flush_dcache_range_hook. The
+ * system registers which identify the running cpu are per-thread variables
+ * set up by host_set_cpu().
+ */
+
+#include <arch.h>
+#include <sched.h>
+#include <stdint.h>
+
+extern __thread uint64_t host_mpidr_el1;
+extern __thread uint64_t host_tpidr_el3;
+extern __thread uint64_t host_sctlr_el3;
+extern uint64_t host_id_aa64isar0_el1;
+extern uint64_t host_id_aa64pfr0_el1;
+extern __thread uint64_t host_cntpct_el0;
+extern __thread uint64_t host_cntp_ctl_el0, host_cntp_cval_el0;
+extern __thread uint64_t host_cntv_ctl_el0, host_cntv_cval_el0;
+extern __thread uint64_t host_cntvoff_el2;
+extern void (*host_flush_dcache_range_hook)(uint64_t addr, uint64_t size);
+
+static inline void dsb(void)		{ __sync_synchronize(); }
+static inline void dmb(void)		{ __sync_synchronize(); }
+static inline void isb(void)		{ __sync_synchronize(); }
+static inline void sev(void)		{ }
+static inline void sevl(void)		{ }
+static inline void wfe(void)		{ sched_yield(); }
+static inline void wfi(void)		{ sched_yield(); }
+
+static inline void dccivac(uint64_t addr)	{ }
+static inline void dccvac(uint64_t addr)	{ }
+static inline void dcivac(uint64_t addr)	{ }
+static inline void dcsw_op_louis(uint32_t op)	{ }
+static inline void inv_dcache_range(uint64_t addr, uint64_t size)	{ }
+
+/* A test can observe the ranges flushed through a hook */
+static inline void flush_dcache_range(uint64_t addr, uint64_t size)
+{
+	if (host_flush_dcache_range_hook)
+		host_flush_dcache_range_hook(addr, size);
+}
+
+static inline uint64_t read_mpidr_el1(void)	{ return host_mpidr_el1; }
+static inline uint64_t read_tpidr_el3(void)	{ return host_tpidr_el3; }
+static inline void write_tpidr_el3(uint64_t v)	{ host_tpidr_el3 = v; }
+
+/* The lower exception levels are not modelled */
+static inline uint64_t read_scr_el3(void)	{ return 0; }
+static inline uint64_t read_sctlr_el1(void)	{ return 0; }
+static inline uint64_t read_sctlr_el2(void)	{ return 0; }
+static inline void write_cntfrq_el0(uint64_t v)	{ }
+
+/* The data cache is on unless a test clears SCTLR_C_BIT in host_sctlr_el3 */
+static inline uint64_t read_sctlr_el3(void)	{ return host_sctlr_el3; }
+
+/* No optional instructions are used unless a test sets them in this register */
+static inline uint64_t read_id_aa64isar0_el1(void)
+{
+	return host_id_aa64isar0_el1;
+}
+
+static inline uint64_t read_id_aa64pfr0_el1(void)
+{
+	return host_id_aa64pfr0_el1;
+}
+
+/* The generic timer of the running cpu is set up by the tests */
+static inline uint64_t read_cntpct_el0(void)	{ return host_cntpct_el0; }
+static inline uint64_t read_cntp_ctl_el0(void)	{ return host_cntp_ctl_el0; }
+static inline uint64_t read_cntp_cval_el0(void)	{ return host_cntp_cval_el0; }
+static inline uint64_t read_cntv_ctl_el0(void)	{ return host_cntv_ctl_el0; }
+static inline uint64_t read_cntv_cval_el0(void)	{ return host_cntv_cval_el0; }
+
+/* CNTVOFF_EL2 is UNDEFINED at EL3 when EL2 is not implemented */
+static inline uint64_t read_cntvoff_el2(void)
+{
+	if (!(host_id_aa64pfr0_el1 &
+	      (ID_AA64PFR0_ELX_MASK << ID_AA64PFR0_EL2_SHIFT)))
+		__builtin_trap();
+	return host_cntvoff_el2;
+}
+
+#define read_mpidr()		read_mpidr_el1()
+
+/* As in lib/aarch64/misc_helpers.S */
+static inline uint32_t get_afflvl_shift(uint32_t aff_lvl)
+{
+	return (aff_lvl == 3 ? 4 : aff_lvl) << MPIDR_AFFLVL_SHIFT;
+}
+
+static inline uint64_t mpidr_mask_lower_afflvls(uint64_t mpidr,
+						uint32_t aff_lvl)
+{
+	unsigned int shift = get_afflvl_shift(aff_lvl);
+
+	return (mpidr >> shift) << shift;
+}
+
+#endif /* __ARCH_HELPERS_H__ */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Stress test of the per-cpu bakery locks (PERCPU_BAKERY_LOCKS=1). Every cpu
+ * of the platform is a host thread which takes a random lock out of a few
+ * and checks that it owns the lock alone for the whole critical section. Half
+ * of the cpus run as if their data cache was disabled, which makes the lock
+ * code take its uncached path. The acquisition latency is recorded and its
+ * distribution printed.
+ */
+
+#include <arch_helpers.h>
+#include <bakery_lock.h>
+#include <platform_def.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include "host_support.h"
+
+#define NUM_LOCKS	4
+
+/*
+ * Keep the number of acquisitions of a lock below the 15-bit limit of the
+ * bakery tickets, which can grow for as long as the lock is never free.
+ */
+#define ITERATIONS	2000
+#define NUM_SAMPLES	(PLATFORM_CORE_COUNT * ITERATIONS)
+
+typedef struct test_lock {
+	bakery_lock_t lock;
+	volatile int owner;
+	unsigned long count;
+} test_lock_t;
+
+static test_lock_t locks[NUM_LOCKS];
+static volatile unsigned int start;
+static uint64_t latency_ns[NUM_SAMPLES];
+
+
+static void *cpu_main(void *arg)
+{
+	unsigned int cpu = (uintptr_t)arg;
+	unsigned int seed = cpu;
+	test_lock_t *l;
+	unsigned long count;
+	uint64_t t;
+	int i;
+
+	host_set_cpu(cpu);
+	if (cpu & 1)
+		host_sctlr_el3 &= ~SCTLR_C_BIT;
+
+	while (!start)
+		sched_yield();
+
+	for (i = 0; i < ITERATIONS; i++) {
+		l = &locks[rand_r(&seed) % NUM_LOCKS];
+
+		t = host_time_ns();
+		bakery_lock_get(&l->lock);
+		latency_ns[cpu * ITERATIONS + i] = host_time_ns() - t;
+
+		CHECK(l->owner == -1);
+		l->owner = cpu;
+		count = l->count;
+
+		/* Give the other cpus a chance to break in */
+		if ((rand_r(&seed) & 7) == 0)
+			sched_yield();
+		l->count = count + 1;
+		CHECK(l->owner == cpu);
+		l->owner = -1;
+
+		bakery_lock_release(&l->lock);
+	}
+
+	return NULL;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+int main(void)
+{
+	pthread_t threads[PLATFORM_CORE_COUNT];
+	unsigned long total = 0;
+	unsigned int cpu, i;
+
+	host_set_cpu(0);
+	for (i = 0; i < NUM_LOCKS; i++) {
+		bakery_lock_init(&locks[i].lock);
+		locks[i].owner = -1;
+	}
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		CHECK(pthread_create(&threads[cpu], NULL, cpu_main,
+				     (void *)(uintptr_t)cpu) == 0);
+	start = 1;
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		pthread_join(threads[cpu], NULL);
+
+	for (i = 0; i < NUM_LOCKS; i++)
+		total += locks[i].count;
+	CHECK(total == NUM_SAMPLES);
+
+	qsort(latency_ns, NUM_SAMPLES, sizeof(latency_ns[0]), compare_u64);
+	printf("  %u cpus, %u locks: latency p50 %llu ns, p99 %llu ns, "
+	       "max %llu ns\n", PLATFORM_CORE_COUNT, NUM_LOCKS,
+	       (unsigned long long)latency_ns[NUM_SAMPLES / 2],
+	       (unsigned long long)latency_ns[NUM_SAMPLES * 99 / 100],
+	       (unsigned long long)latency_ns[NUM_SAMPLES - 1]);
+
+	return host_test_result("test_bakery_lock");
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Model of the image copies shared between the primary cpu and helper cpus in
+ * BL2. Host threads play the part of the helpers started by the platform. The
+ * flushes of the copied ranges are traced, and the test checks that:
+ *
+ * - images of more than one chunk are split between the cpus when helpers
+ *   are running, and the chunks flushed by all cpus cover the image exactly
+ *   once;
+ * - each chunk ends on a chunk boundary of the destination, so that no cache
+ *   line is written by two cpus, and is no longer than a chunk;
+ * - each chunk has been copied when it is flushed;
+ * - copy_image() returns only when the whole image is in place, and nothing
+ *   outside of it is written;
+ * - the helpers have all returned before bl2_plat_stop_load_helpers().
+ */
+
+#include <arch_helpers.h>
+#include <bl_common.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../bl2/bl2_private.h"
+#include "host_support.h"
+
+/* As in bl2/bl2_parallel_load.c */
+#define LOAD_CHUNK_SIZE		(64 * 1024)
+
+#define MAX_IMAGE_SIZE		(20 * LOAD_CHUNK_SIZE + 123)
+#define GUARD_SIZE		64
+#define NUM_TRIALS		40
+#define MAX_CHUNKS		(MAX_IMAGE_SIZE / LOAD_CHUNK_SIZE + 2)
+
+typedef struct chunk {
+	uint64_t addr;
+	uint64_t size;
+	unsigned int cpu;
+} chunk_t;
+
+static uint8_t src_buf[MAX_IMAGE_SIZE + LOAD_CHUNK_SIZE];
+static uint8_t dst_buf[MAX_IMAGE_SIZE + 2 * LOAD_CHUNK_SIZE];
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static chunk_t chunks[MAX_CHUNKS];
+static unsigned int num_chunks;
+static const uint8_t *trace_src;
+static uint64_t trace_dst;
+
+static pthread_t helper_threads[PLATFORM_CORE_COUNT];
+static unsigned int num_helpers, helpers_running;
+static unsigned long helper_chunks;
+
+
+/* Record a flushed chunk, which must already hold its copy of the image */
+static void trace_flush(uint64_t addr, uint64_t size)
+{
+	const uint8_t *src = trace_src + (addr - trace_dst);
+	unsigned int cpu = platform_get_core_pos(read_mpidr_el1());
+
+	CHECK(memcmp((const void *)addr, src, size) == 0);
+
+	pthread_mutex_lock(&trace_lock);
+	CHECK(num_chunks < MAX_CHUNKS);
+	if (num_chunks < MAX_CHUNKS) {
+		chunks[num_chunks].addr = addr;
+		chunks[num_chunks].size = size;
+		chunks[num_chunks].cpu = cpu;
+		num_chunks++;
+	}
+	if (cpu != 0)
+		helper_chunks++;
+	pthread_mutex_unlock(&trace_lock);
+
+	/* Let the helpers claim chunks even when the host has a single cpu */
+	sched_yield();
+}
+
+static void *helper_main(void *arg)
+{
+	host_set_cpu((uintptr_t)arg);
+	bl2_load_helper_main();
+	__atomic_sub_fetch(&helpers_running, 1, __ATOMIC_SEQ_CST);
+
+	return NULL;
+}
+
+unsigned int bl2_plat_start_load_helpers(void)
+{
+	unsigned int i;
+
+	helpers_running = num_helpers;
+	for (i = 0; i < num_helpers; i++)
+		CHECK(pthread_create(&helper_threads[i], NULL, helper_main,
+				     (void *)(uintptr_t)(i + 1)) == 0);
+
+	return num_helpers;
+}
+
+void bl2_plat_stop_load_helpers(void)
+{
+	unsigned int i;
+
+	/* The helpers must no longer run BL2 code */
+	CHECK(helpers_running == 0);
+	for (i = 0; i < num_helpers; i++)
+		pthread_join(helper_threads[i], NULL);
+}
+
+static int compare_chunks(const void *a, const void *b)
+{
+	const chunk_t *x = a, *y = b;
+
+	return (x->addr > y->addr) - (x->addr < y->addr);
+}
+
+/* Check the traced chunks against the image copied to 'dst' */
+static void check_chunks(uint64_t dst, size_t size)
+{
+	uint64_t next = dst;
+	unsigned int i;
+
+	qsort(chunks, num_chunks, sizeof(chunks[0]), compare_chunks);
+
+	for (i = 0; i < num_chunks; i++) {
+		CHECK(chunks[i].addr == next);
+		CHECK(chunks[i].size != 0);
+		CHECK(chunks[i].size <= LOAD_CHUNK_SIZE);
+
+		/* A chunk may only end at a chunk boundary or the image end */
+		next = chunks[i].addr + chunks[i].size;
+		if (next != dst + size)
+			CHECK((next & (LOAD_CHUNK_SIZE - 1)) == 0);
+	}
+	CHECK(next == dst + size);
+}
+
+static void run_trial(unsigned int *seed)
+{
+	size_t size, dst_off, src_off, i;
+	uint8_t *dst, *src;
+
+	size = rand_r(seed) % MAX_IMAGE_SIZE;
+	if (rand_r(seed) & 1)
+		size &= ~(size_t)(LOAD_CHUNK_SIZE - 1);
+	dst_off = GUARD_SIZE + rand_r(seed) % (LOAD_CHUNK_SIZE - GUARD_SIZE);
+	if (rand_r(seed) & 1)
+		dst_off &= ~(size_t)(CACHE_WRITEBACK_GRANULE - 1);
+	src_off = rand_r(seed) % LOAD_CHUNK_SIZE;
+
+	src = &src_buf[src_off];
+	dst = &dst_buf[dst_off];
+	for (i = 0; i < size; i++)
+		src[i] = rand_r(seed);
+	memset(dst_buf, 0xa5, sizeof(dst_buf));
+
+	num_chunks = 0;
+	trace_src = src;
+	trace_dst = (uintptr_t)dst;
+
+	copy_image((uintptr_t)dst, (uintptr_t)src, size);
+
+	CHECK(memcmp(dst, src, size) == 0);
+	for (i = 0; i < dst_off; i++)
+		CHECK(dst_buf[i] == 0xa5);
+	for (i = dst_off + size; i < sizeof(dst_buf); i++)
+		if (dst_buf[i] != 0xa5)
+			break;
+	CHECK(i == sizeof(dst_buf));
+
+	/* Small images and images loaded without helpers are not split */
+	if ((num_helpers == 0) || (size <= LOAD_CHUNK_SIZE)) {
+		CHECK(num_chunks == 1);
+		CHECK(chunks[0].addr == (uintptr_t)dst);
+		CHECK(chunks[0].size == size);
+		CHECK(chunks[0].cpu == 0);
+	} else {
+		check_chunks((uintptr_t)dst, size);
+	}
+}
+
+int main(void)
+{
+	static const unsigned int helper_counts[] = { 0, 1, 3,
+						      PLATFORM_CORE_COUNT - 1 };
+	unsigned int seed = 1, h, t;
+
+	host_set_cpu(0);
+	host_flush_dcache_range_hook = trace_flush;
+
+	for (h = 0; h < sizeof(helper_counts) / sizeof(helper_counts[0]);
+	     h++) {
+		num_helpers = helper_counts[h];
+		helper_chunks = 0;
+
+		bl2_parallel_load_init();
+		for (t = 0; t < NUM_TRIALS; t++)
+			run_trial(&seed);
+		bl2_parallel_load_exit();
+
+		printf("  %u helper(s): %lu chunks copied by the helpers\n",
+		       num_helpers, helper_chunks);
+		if (num_helpers == 0)
+			CHECK(helper_chunks == 0);
+		else
+			CHECK(helper_chunks != 0);
+	}
+
+	return host_test_result("test_bl2_parallel_load");
+}
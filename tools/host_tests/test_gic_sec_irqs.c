@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Runs gicd_setup_sec_irqs() against an emulated GICv2 distributor and checks
+ * that it leaves the distributor in the same state as configuring each secure
+ * interrupt in turn with the single interrupt accessors, as the GIC driver did
+ * before. Also checks that each register word is accessed at most once.
+ */
+
+#include <gic_v2.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_support.h"
+
+#define NUM_TRIALS		2000
+
+/* Two distributors: one set up by gicd_setup_sec_irqs(), one by reference */
+#define GICD_BASE		0x2f000000
+#define GICD_REF_BASE		0x2f100000
+#define GICD_FRAME_SIZE		0x1000
+
+/* Number of interrupt ids implemented, i.e. GICD_TYPER.ITLinesNumber is 7 */
+#define NUM_WORDS		8
+#define NUM_IDS			(NUM_WORDS << IGROUPR_SHIFT)
+
+/* The interface of the cpu reading the SGI and PPI targets */
+#define CPU_IFACE		0
+
+typedef struct gicd {
+	uint32_t group[NUM_WORDS];
+	uint32_t enable[NUM_WORDS];
+	uint8_t priority[NUM_IDS];
+	uint8_t target[NUM_IDS];
+} gicd_t;
+
+typedef struct gicd_accesses {
+	unsigned int group_reads[NUM_WORDS], group_writes[NUM_WORDS];
+	unsigned int enable_reads[NUM_WORDS], enable_writes[NUM_WORDS];
+	unsigned int priority_reads[NUM_IDS >> IPRIORITYR_SHIFT];
+	unsigned int priority_writes[NUM_IDS >> IPRIORITYR_SHIFT];
+	unsigned int target_reads[NUM_IDS >> ITARGETSR_SHIFT];
+	unsigned int target_writes[NUM_IDS >> ITARGETSR_SHIFT];
+	unsigned long total;
+} gicd_accesses_t;
+
+static gicd_t gicd, gicd_ref;
+static gicd_accesses_t accesses, ref_accesses;
+
+
+static gicd_t *decode(uintptr_t addr, unsigned int *offset,
+		      gicd_accesses_t **acc)
+{
+	CHECK((addr & 3) == 0);
+
+	if (addr >= GICD_BASE && addr < GICD_BASE + GICD_FRAME_SIZE) {
+		*offset = addr - GICD_BASE;
+		*acc = &accesses;
+		return &gicd;
+	}
+
+	CHECK(addr >= GICD_REF_BASE && addr < GICD_REF_BASE + GICD_FRAME_SIZE);
+	*offset = addr - GICD_REF_BASE;
+	*acc = &ref_accesses;
+	return &gicd_ref;
+}
+
+uint32_t host_mmio_read_32(uintptr_t addr)
+{
+	gicd_accesses_t *acc;
+	unsigned int off, n;
+	gicd_t *d = decode(addr, &off, &acc);
+	uint32_t val = 0;
+
+	acc->total++;
+
+	if (off == GICD_TYPER)
+		return NUM_WORDS - 1;
+
+	if (off >= GICD_IGROUPR && off < GICD_IGROUPR + NUM_WORDS * 4) {
+		n = (off - GICD_IGROUPR) >> 2;
+		acc->group_reads[n]++;
+		return d->group[n];
+	}
+
+	if (off >= GICD_ISENABLER && off < GICD_ISENABLER + NUM_WORDS * 4) {
+		n = (off - GICD_ISENABLER) >> 2;
+		acc->enable_reads[n]++;
+		return d->enable[n];
+	}
+
+	if (off >= GICD_IPRIORITYR && off < GICD_IPRIORITYR + NUM_IDS) {
+		n = off - GICD_IPRIORITYR;
+		acc->priority_reads[n >> 2]++;
+		memcpy(&val, &d->priority[n], 4);
+		return val;
+	}
+
+	if (off >= GICD_ITARGETSR && off < GICD_ITARGETSR + NUM_IDS) {
+		n = off - GICD_ITARGETSR;
+		acc->target_reads[n >> 2]++;
+
+		/* The SGI and PPI targets read as the reading cpu */
+		if (n < MIN_SPI_ID)
+			return (1 << CPU_IFACE) * 0x01010101;
+		memcpy(&val, &d->target[n], 4);
+		return val;
+	}
+
+	/* No other register is expected to be read */
+	CHECK(0);
+	return 0;
+}
+
+void host_mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	gicd_accesses_t *acc;
+	unsigned int off, n;
+	gicd_t *d = decode(addr, &off, &acc);
+
+	acc->total++;
+
+	if (off >= GICD_IGROUPR && off < GICD_IGROUPR + NUM_WORDS * 4) {
+		n = (off - GICD_IGROUPR) >> 2;
+		acc->group_writes[n]++;
+		d->group[n] = value;
+		return;
+	}
+
+	/* Writing ones enables the corresponding interrupts */
+	if (off >= GICD_ISENABLER && off < GICD_ISENABLER + NUM_WORDS * 4) {
+		n = (off - GICD_ISENABLER) >> 2;
+		acc->enable_writes[n]++;
+		d->enable[n] |= value;
+		return;
+	}
+
+	if (off >= GICD_IPRIORITYR && off < GICD_IPRIORITYR + NUM_IDS) {
+		n = off - GICD_IPRIORITYR;
+		acc->priority_writes[n >> 2]++;
+		memcpy(&d->priority[n], &value, 4);
+		return;
+	}
+
+	/* The SGI and PPI targets are read only */
+	if (off >= GICD_ITARGETSR && off < GICD_ITARGETSR + NUM_IDS) {
+		n = off - GICD_ITARGETSR;
+		acc->target_writes[n >> 2]++;
+		if (n >= MIN_SPI_ID)
+			memcpy(&d->target[n], &value, 4);
+		return;
+	}
+
+	/* No other register is expected to be written */
+	CHECK(0);
+}
+
+/*
+ * Configure the secure interrupts of a range one at a time, as
+ * arm_gic_distif_setup() and arm_gic_pcpu_distif_setup() used to
+ */
+static void setup_sec_irqs_ref(unsigned int first_id, unsigned int num_ids,
+			       const unsigned int *irqs, unsigned int num_irqs,
+			       unsigned int pri, unsigned int iface)
+{
+	unsigned int id, index;
+
+	for (id = first_id; id < first_id + num_ids; id += 1 << IGROUPR_SHIFT)
+		gicd_write_igroupr(GICD_REF_BASE, id, ~0);
+
+	for (index = 0; index < num_irqs; index++) {
+		id = irqs[index];
+		if (id < first_id || id >= first_id + num_ids)
+			continue;
+
+		gicd_clr_igroupr(GICD_REF_BASE, id);
+		gicd_set_ipriorityr(GICD_REF_BASE, id, pri);
+		if (id >= MIN_SPI_ID)
+			gicd_set_itargetsr(GICD_REF_BASE, id, iface);
+		gicd_set_isenabler(GICD_REF_BASE, id);
+	}
+}
+
+/* Check that each word of the range was accessed as often as expected */
+static void check_accesses(unsigned int first_id, unsigned int num_ids,
+			   const unsigned int *irqs, unsigned int num_irqs)
+{
+	unsigned int id, index, n, sec;
+
+	for (id = first_id; id < first_id + num_ids; id += 1 << IGROUPR_SHIFT) {
+		n = id >> IGROUPR_SHIFT;
+		sec = 0;
+		for (index = 0; index < num_irqs; index++)
+			if (irqs[index] >> IGROUPR_SHIFT == n)
+				sec |= 1 << (irqs[index] & 31);
+
+		CHECK(accesses.group_reads[n] == 0);
+		CHECK(accesses.group_writes[n] == 1);
+		CHECK(accesses.enable_reads[n] == 0);
+		CHECK(accesses.enable_writes[n] == (sec != 0));
+	}
+
+	for (id = first_id; id < first_id + num_ids; id += 4) {
+		n = id >> IPRIORITYR_SHIFT;
+		sec = 0;
+		for (index = 0; index < num_irqs; index++)
+			sec |= (irqs[index] >> IPRIORITYR_SHIFT == n);
+
+		CHECK(accesses.priority_reads[n] == sec);
+		CHECK(accesses.priority_writes[n] == sec);
+		if (id < MIN_SPI_ID)
+			sec = 0;
+		CHECK(accesses.target_reads[n] == sec);
+		CHECK(accesses.target_writes[n] == sec);
+	}
+}
+
+static void check_same_state(void)
+{
+	CHECK(memcmp(gicd.group, gicd_ref.group, sizeof(gicd.group)) == 0);
+	CHECK(memcmp(gicd.enable, gicd_ref.enable, sizeof(gicd.enable)) == 0);
+	CHECK(memcmp(gicd.priority, gicd_ref.priority,
+		     sizeof(gicd.priority)) == 0);
+	CHECK(memcmp(gicd.target, gicd_ref.target, sizeof(gicd.target)) == 0);
+}
+
+int main(void)
+{
+	unsigned int irqs[64], num_irqs, pri, iface, trial, i;
+	unsigned long total = 0, ref_total = 0;
+	uint8_t *p = (uint8_t *)&gicd;
+
+	srand(1);
+
+	for (trial = 0; trial < NUM_TRIALS; trial++) {
+		/* Start from an arbitrary distributor state */
+		for (i = 0; i < sizeof(gicd); i++)
+			p[i] = rand();
+		memset(gicd.target, 0, MIN_SPI_ID);
+		gicd_ref = gicd;
+
+		/*
+		 * Pick some interrupts, including duplicates and ids beyond
+		 * the implemented ones, which must be ignored
+		 */
+		num_irqs = rand() % 64;
+		for (i = 0; i < num_irqs; i++)
+			irqs[i] = rand() % (NUM_IDS + 64);
+		pri = rand() % (GIC_LOWEST_SEC_PRIORITY + 1);
+		iface = rand() % 8;
+
+		/* The boot cpu sets up the SPIs, then each cpu its own */
+		memset(&accesses, 0, sizeof(accesses));
+		gicd_setup_sec_irqs(GICD_BASE, MIN_SPI_ID, NUM_IDS - MIN_SPI_ID,
+				    irqs, num_irqs, pri, iface);
+		setup_sec_irqs_ref(MIN_SPI_ID, NUM_IDS - MIN_SPI_ID,
+				   irqs, num_irqs, pri, iface);
+		check_accesses(MIN_SPI_ID, NUM_IDS - MIN_SPI_ID,
+			       irqs, num_irqs);
+		check_same_state();
+		total += accesses.total;
+
+		memset(&accesses, 0, sizeof(accesses));
+		gicd_setup_sec_irqs(GICD_BASE, MIN_SGI_ID,
+				    MIN_SPI_ID - MIN_SGI_ID,
+				    irqs, num_irqs, pri, 0);
+		setup_sec_irqs_ref(MIN_SGI_ID, MIN_SPI_ID - MIN_SGI_ID,
+				   irqs, num_irqs, pri, 0);
+		check_accesses(MIN_SGI_ID, MIN_SPI_ID - MIN_SGI_ID,
+			       irqs, num_irqs);
+		check_same_state();
+		total += accesses.total;
+	}
+
+	ref_total = ref_accesses.total;
+	printf("test_gic_sec_irqs: %lu register accesses, %lu one interrupt "
+	       "at a time\n", total, ref_total);
+
+	return host_test_result("test_gic_sec_irqs");
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Reads images out of a Firmware Image Package held in memory through the FIP
+ * driver stacked on the memmap driver, and checks with the backend counters
+ * that the package is opened and its Table of Contents parsed only once. Also
+ * checks that the device is not closed under open files and that positional
+ * reads are clipped to the end of a file or memmap block.
+ */
+
+#include <firmware_image_package.h>
+#include <io_fip.h>
+#include <io_memmap.h>
+#include <io_storage.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <string.h>
+#include "host_support.h"
+
+#define FIP_IMAGE_NAME		"fip.bin"
+#define PAYLOAD_SIZE		5000
+#define READ_CHUNK		768
+
+static const uuid_t uuid_bl2 = UUID_TRUSTED_BOOT_FIRMWARE_BL2;
+static const uuid_t uuid_bl31 = UUID_EL3_RUNTIME_FIRMWARE_BL31;
+static const uuid_t uuid_bl33 = UUID_NON_TRUSTED_FIRMWARE_BL33;
+
+/* Header, three entries and the terminating one, then the payloads */
+#define FIP_TOC_SIZE	(sizeof(fip_toc_header_t) + 4 * sizeof(fip_toc_entry_t))
+#define FIP_SIZE	(FIP_TOC_SIZE + 3 * PAYLOAD_SIZE)
+
+static uint8_t fip[FIP_SIZE];
+
+static uintptr_t memmap_dev_handle;
+static io_block_spec_t fip_block_spec = {
+	.offset = (size_t)fip,
+	.length = sizeof(fip)
+};
+
+
+int plat_get_image_source(const char *image_name, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+	if (strcmp(image_name, FIP_IMAGE_NAME) != 0)
+		return IO_FAIL;
+
+	*dev_handle = memmap_dev_handle;
+	*image_spec = (uintptr_t)&fip_block_spec;
+	return IO_SUCCESS;
+}
+
+/* Each payload byte identifies the image and its offset in the image */
+static uint8_t payload_byte(unsigned int image, size_t offset)
+{
+	return (uint8_t)(image * 83 + offset * 7 + (offset >> 8));
+}
+
+static void build_fip(void)
+{
+	fip_toc_header_t *header = (fip_toc_header_t *)fip;
+	fip_toc_entry_t *entry = (fip_toc_entry_t *)(header + 1);
+	const uuid_t *uuids[] = { &uuid_bl2, &uuid_bl31, &uuid_bl33 };
+	unsigned int image;
+	size_t offset;
+
+	header->name = TOC_HEADER_NAME;
+	header->serial_number = 1;
+
+	for (image = 0; image < 3; image++, entry++) {
+		entry->uuid = *uuids[image];
+		entry->offset_address = FIP_TOC_SIZE + image * PAYLOAD_SIZE;
+		entry->size = PAYLOAD_SIZE;
+		for (offset = 0; offset < PAYLOAD_SIZE; offset++)
+			fip[entry->offset_address + offset] =
+				payload_byte(image, offset);
+	}
+}
+
+/* Check that a buffer holds the bytes of an image from a given offset */
+static int check_payload(const uint8_t *buf, unsigned int image,
+			 size_t offset, size_t length)
+{
+	size_t i;
+
+	for (i = 0; i < length; i++)
+		if (buf[i] != payload_byte(image, offset + i))
+			return 0;
+	return 1;
+}
+
+static int open_image(uintptr_t fip_dev_handle, const char *name,
+		      uintptr_t *handle)
+{
+	io_file_spec_t spec = { .path = name, .mode = IO_MODE_RO };
+
+	return io_open(fip_dev_handle, (uintptr_t)&spec, handle);
+}
+
+int main(void)
+{
+	const struct io_dev_connector *memmap_dev_con, *fip_dev_con;
+	uintptr_t fip_dev_handle, bl2, bl31, bl33, block;
+	fip_backend_stats_t stats, init_stats;
+	uint8_t buf[2][READ_CHUNK];
+	size_t pos, len[2], size;
+	uintptr_t address;
+
+	build_fip();
+
+	CHECK(register_io_dev_memmap(&memmap_dev_con) == IO_SUCCESS);
+	CHECK(register_io_dev_fip(&fip_dev_con) == IO_SUCCESS);
+	CHECK(io_dev_open(memmap_dev_con, 0, &memmap_dev_handle) ==
+	      IO_SUCCESS);
+	CHECK(io_dev_open(fip_dev_con, 0, &fip_dev_handle) == IO_SUCCESS);
+
+	/* The header and every entry of the ToC are read once at init */
+	CHECK(io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_NAME) ==
+	      IO_SUCCESS);
+	fip_get_backend_stats(&init_stats);
+	CHECK(init_stats.open_count == 1);
+	CHECK(init_stats.read_count == 1 + 4);
+
+	/* Initialising the device again does not touch the backend */
+	CHECK(io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_NAME) ==
+	      IO_SUCCESS);
+	fip_get_backend_stats(&stats);
+	CHECK(stats.open_count == init_stats.open_count);
+	CHECK(stats.read_count == init_stats.read_count);
+
+	/* Opening files is served from the cached ToC */
+	CHECK(open_image(fip_dev_handle, BL2_IMAGE_NAME, &bl2) == IO_SUCCESS);
+	CHECK(open_image(fip_dev_handle, BL31_IMAGE_NAME, &bl31) ==
+	      IO_SUCCESS);
+	CHECK(open_image(fip_dev_handle, BL32_IMAGE_NAME, &bl33) == IO_FAIL);
+	CHECK(open_image(fip_dev_handle, BL33_IMAGE_NAME, &bl33) ==
+	      IO_RESOURCES_EXHAUSTED);
+	fip_get_backend_stats(&stats);
+	CHECK(stats.open_count == init_stats.open_count);
+	CHECK(stats.read_count == init_stats.read_count);
+
+	CHECK(io_size(bl31, &size) == IO_SUCCESS);
+	CHECK(size == PAYLOAD_SIZE);
+
+	/* Interleaved reads from both files, one backend read each */
+	for (pos = 0; pos < PAYLOAD_SIZE; pos += len[0]) {
+		CHECK(io_read(bl2, (uintptr_t)buf[0], READ_CHUNK, &len[0]) ==
+		      IO_SUCCESS);
+		CHECK(io_read(bl31, (uintptr_t)buf[1], READ_CHUNK, &len[1]) ==
+		      IO_SUCCESS);
+		CHECK(len[0] == len[1] && len[0] != 0);
+		CHECK(check_payload(buf[0], 0, pos, len[0]));
+		CHECK(check_payload(buf[1], 1, pos, len[1]));
+	}
+	CHECK(pos == PAYLOAD_SIZE);
+	fip_get_backend_stats(&stats);
+	CHECK(stats.open_count == init_stats.open_count);
+	CHECK(stats.read_count == init_stats.read_count +
+	      2 * ((PAYLOAD_SIZE + READ_CHUNK - 1) / READ_CHUNK));
+
+	/* Positional reads are clipped to the file and leave the cursor */
+	CHECK(io_read_at(bl2, PAYLOAD_SIZE - 100, (uintptr_t)buf[0],
+			 READ_CHUNK, &len[0]) == IO_SUCCESS);
+	CHECK(len[0] == 100);
+	CHECK(check_payload(buf[0], 0, PAYLOAD_SIZE - 100, len[0]));
+	CHECK(io_read(bl2, (uintptr_t)buf[0], READ_CHUNK, &len[0]) ==
+	      IO_SUCCESS);
+	CHECK(len[0] == 0);
+
+	/* The payloads of a memory-mapped package can be used in place */
+	CHECK(io_get_direct_address(bl31, &address) == IO_SUCCESS);
+	CHECK(address == (uintptr_t)fip + FIP_TOC_SIZE + PAYLOAD_SIZE);
+
+	/* A slot freed by closing a file can be reused */
+	CHECK(io_close(bl2) == IO_SUCCESS);
+	CHECK(open_image(fip_dev_handle, BL33_IMAGE_NAME, &bl33) ==
+	      IO_SUCCESS);
+	CHECK(io_read(bl33, (uintptr_t)buf[0], READ_CHUNK, &len[0]) ==
+	      IO_SUCCESS);
+	CHECK(check_payload(buf[0], 2, 0, len[0]));
+
+	/* The device cannot be closed under the files still open */
+	CHECK(io_dev_close(fip_dev_handle) == IO_FAIL);
+	CHECK(io_read_at(bl33, 0, (uintptr_t)buf[0], READ_CHUNK, &len[0]) ==
+	      IO_SUCCESS);
+	CHECK(check_payload(buf[0], 2, 0, len[0]));
+	CHECK(io_close(bl31) == IO_SUCCESS);
+	CHECK(io_dev_close(fip_dev_handle) == IO_FAIL);
+	CHECK(io_close(bl33) == IO_SUCCESS);
+
+	/* Closing the device releases the backend; it is reopened on init */
+	CHECK(io_dev_close(fip_dev_handle) == IO_SUCCESS);
+	CHECK(io_dev_open(fip_dev_con, 0, &fip_dev_handle) == IO_SUCCESS);
+	CHECK(io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_NAME) ==
+	      IO_SUCCESS);
+	fip_get_backend_stats(&stats);
+	CHECK(stats.open_count == 2 * init_stats.open_count);
+	CHECK(io_dev_close(fip_dev_handle) == IO_SUCCESS);
+
+	/* Positional reads from a memmap block are clipped to the block */
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&fip_block_spec,
+		      &block) == IO_SUCCESS);
+	CHECK(io_read_at(block, sizeof(fip) - 10, (uintptr_t)buf[0],
+			 READ_CHUNK, &len[0]) == IO_SUCCESS);
+	CHECK(len[0] == 10);
+	CHECK(memcmp(buf[0], &fip[sizeof(fip) - 10], 10) == 0);
+	CHECK(io_read_at(block, sizeof(fip), (uintptr_t)buf[0],
+			 READ_CHUNK, &len[0]) == IO_SUCCESS);
+	CHECK(len[0] == 0);
+	CHECK(io_read_at(block, sizeof(fip) + 1, (uintptr_t)buf[0],
+			 READ_CHUNK, &len[0]) == IO_FAIL);
+	CHECK(io_close(block) == IO_SUCCESS);
+
+	return host_test_result("test_io_fip");
+}
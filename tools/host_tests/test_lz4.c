@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Compresses images with the LZ4 block compressor of fip_create and decodes
+ * them with the firmware's stream decoder reading through the memmap driver.
+ * Checks the round trip on data of various sizes and compressibility, a block
+ * made by the reference lz4 tool, and the rejection of malformed blocks
+ * without writing outside the destination, and that the output hashed while it
+ * is decoded has the digest of the image. Reports the decoding throughput,
+ * with and without hashing.
+ */
+
+#include <errno.h>
+#include <io_memmap.h>
+#include <io_storage.h>
+#include <lz4.h>
+#include <sha256.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "host_support.h"
+#include "lz4_compress.h"
+
+#define MAX_IMAGE_SIZE		(4 * 1024 * 1024)
+#define GUARD_SIZE		64
+#define GUARD_BYTE		0xa5
+#define NUM_MUTATIONS		5000
+#define THROUGHPUT_ROUNDS	16
+
+/* Output of "lz4 -l -9" for KAT_PLAIN, less the legacy frame header */
+static const char kat_plain[] =
+	"ARM Trusted Firmware, ARM Trusted Firmware, ARM Trusted Firmware! "
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa abababababababababab end.";
+static const uint8_t kat_block[] = {
+	0xff, 0x07, 0x41, 0x52, 0x4d, 0x20, 0x54, 0x72, 0x75, 0x73,
+	0x74, 0x65, 0x64, 0x20, 0x46, 0x69, 0x72, 0x6d, 0x77, 0x61,
+	0x72, 0x65, 0x2c, 0x20, 0x16, 0x00, 0x17, 0x3f, 0x21, 0x20,
+	0x61, 0x01, 0x00, 0x14, 0x3e, 0x20, 0x61, 0x62, 0x02, 0x00,
+	0x50, 0x20, 0x65, 0x6e, 0x64, 0x2e
+};
+
+static uint8_t image[MAX_IMAGE_SIZE];
+static uint8_t block[LZ4_COMPRESS_BOUND(MAX_IMAGE_SIZE)];
+static uint8_t out[MAX_IMAGE_SIZE + GUARD_SIZE];
+
+static uintptr_t memmap_dev_handle;
+
+
+/* Decode a block held in memory through the IO layer, hashing the output */
+static int decode_hashed(const uint8_t *src, size_t src_size, size_t dst_size,
+			 sha256_ctx_t *hash)
+{
+	io_block_spec_t spec = {
+		.offset = (size_t)src,
+		.length = src_size
+	};
+	uintptr_t handle;
+	int result;
+
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&spec, &handle) ==
+	      IO_SUCCESS);
+	result = lz4_decode_stream(handle, src_size, (uintptr_t)out, dst_size,
+				   hash);
+	CHECK(io_close(handle) == IO_SUCCESS);
+
+	return result;
+}
+
+static int decode(const uint8_t *src, size_t src_size, size_t dst_size)
+{
+	return decode_hashed(src, src_size, dst_size, NULL);
+}
+
+/* Check that the output hashed while decoding has the digest of the image */
+static void check_hash(const uint8_t *src, size_t src_size, size_t size)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE], expected[SHA256_DIGEST_SIZE];
+	sha256_ctx_t hash;
+
+	sha256_init(&hash);
+	sha256_update(&hash, image, size);
+	sha256_final(&hash, expected);
+
+	sha256_init(&hash);
+	CHECK(decode_hashed(src, src_size, size, &hash) == 0);
+	sha256_final(&hash, digest);
+	CHECK(memcmp(digest, expected, sizeof(digest)) == 0);
+}
+
+/* Check that nothing was written past the first 'size' bytes of out[] */
+static int guard_intact(size_t size)
+{
+	size_t i;
+
+	for (i = size; i < size + GUARD_SIZE; i++)
+		if (out[i] != GUARD_BYTE)
+			return 0;
+	return 1;
+}
+
+/* Fill the image with data of a given kind */
+static void make_image(unsigned int kind, size_t size, unsigned int seed)
+{
+	static const char *words[] = {
+		"psci", "cpu", "suspend", "secure", "world", "el3", "fip",
+		"image", "load", "gic", "timer", "\n", " ", "0x", "mpidr"
+	};
+	size_t i, n;
+
+	switch (kind) {
+	case 0:		/* Incompressible */
+		for (i = 0; i < size; i++)
+			image[i] = rand_r(&seed);
+		break;
+	case 1:		/* A single repeated byte */
+		memset(image, seed, size);
+		break;
+	case 2:		/* Short periods, whose matches overlap */
+		for (i = 0; i < size; i++)
+			image[i] = "abcdefg"[i % (seed % 7 + 1)];
+		break;
+	default:	/* Text-like, with distant and nearby repetition */
+		for (i = 0; i < size; i += n) {
+			const char *w = words[rand_r(&seed) % 15];
+
+			n = strlen(w);
+			if (n > size - i)
+				n = size - i;
+			memcpy(&image[i], w, n);
+		}
+		break;
+	}
+}
+
+static void check_round_trip(unsigned int kind, size_t size,
+			     unsigned int seed)
+{
+	size_t block_size;
+
+	make_image(kind, size, seed);
+	block_size = lz4_compress_block(image, size, block);
+	CHECK(block_size <= LZ4_COMPRESS_BOUND(size));
+	if (kind != 0 && size >= 1024)
+		CHECK(block_size < size * 3 / 4);
+
+	memset(out, GUARD_BYTE, size + GUARD_SIZE);
+	CHECK(decode(block, block_size, size) == 0);
+	CHECK(memcmp(out, image, size) == 0);
+	CHECK(guard_intact(size));
+	check_hash(block, block_size, size);
+
+	/* The decoded size must match exactly and the block be complete */
+	if (size != 0) {
+		CHECK(decode(block, block_size, size - 1) == -EINVAL);
+		CHECK(decode(block, block_size - 1, size) != 0);
+	}
+	memset(out, GUARD_BYTE, size + 1 + GUARD_SIZE);
+	CHECK(decode(block, block_size, size + 1) == -EINVAL);
+	CHECK(guard_intact(size + 1));
+}
+
+/* Corrupt a valid block in various ways, which must not overrun out[] */
+static void check_malformed(void)
+{
+	static uint8_t bad[8192];
+	unsigned int seed = 1, i, n;
+	size_t block_size, size = 4096;
+	int rejected = 0;
+	uint8_t *end, *tail_block;
+	long page;
+
+	make_image(3, size, 7);
+	block_size = lz4_compress_block(image, size, block);
+	CHECK(block_size <= sizeof(bad));
+
+	for (i = 0; i < NUM_MUTATIONS; i++) {
+		memcpy(bad, block, block_size);
+		for (n = rand_r(&seed) % 4 + 1; n > 0; n--)
+			bad[rand_r(&seed) % block_size] = rand_r(&seed);
+
+		memset(out, GUARD_BYTE, size + GUARD_SIZE);
+		if (decode(bad, block_size, size) != 0)
+			rejected++;
+		CHECK(guard_intact(size));
+	}
+	CHECK(rejected != 0);
+
+	/* A match may not refer to before the start of the image */
+	bad[0] = 0x10;
+	bad[1] = 'x';
+	bad[2] = 2;
+	bad[3] = 0;
+	bad[4] = 0x10;
+	bad[5] = 'y';
+	CHECK(decode(bad, 6, 1 + 4 + 1) == -EINVAL);
+	bad[2] = 0;
+	CHECK(decode(bad, 6, 1 + 4 + 1) == -EINVAL);
+	bad[2] = 1;
+	CHECK(decode(bad, 6, 1 + 4 + 1) == 0);
+	CHECK(memcmp(out, "xxxxxy", 6) == 0);
+
+	/*
+	 * A long literal run may not extend past the end of the block. The
+	 * block is placed right before an inaccessible page, so that reading
+	 * beyond it faults.
+	 */
+	page = sysconf(_SC_PAGESIZE);
+	end = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	CHECK(end != MAP_FAILED);
+	if (end == MAP_FAILED)
+		return;
+	end += page;
+	CHECK(mprotect(end, page, PROT_NONE) == 0);
+	tail_block = end - 100;
+	memset(tail_block, 0, 100);
+	tail_block[0] = 0xf0;
+	for (n = 1; n < 9; n++)
+		tail_block[n] = 255;
+	memset(out, GUARD_BYTE, size + GUARD_SIZE);
+	CHECK(decode(tail_block, 100, size) == -EINVAL);
+	CHECK(guard_intact(size));
+	munmap(end - page, 2 * page);
+}
+
+/*
+ * Report the decoding speed of a text-like image against a plain read, and
+ * that of hashing the output as it is decoded against hashing it afterwards
+ */
+static void measure_throughput(void)
+{
+	io_block_spec_t spec = { .offset = (size_t)image };
+	size_t size = MAX_IMAGE_SIZE, block_size, bytes_read;
+	uint64_t t, decode_ns = 0, read_ns = 0, inline_ns = 0, after_ns = 0;
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	sha256_ctx_t hash;
+	uintptr_t handle;
+	unsigned int i;
+
+	make_image(3, size, 11);
+	block_size = lz4_compress_block(image, size, block);
+	spec.length = size;
+
+	for (i = 0; i < THROUGHPUT_ROUNDS; i++) {
+		t = host_time_ns();
+		CHECK(decode(block, block_size, size) == 0);
+		decode_ns += host_time_ns() - t;
+
+		t = host_time_ns();
+		CHECK(io_open(memmap_dev_handle, (uintptr_t)&spec, &handle) ==
+		      IO_SUCCESS);
+		CHECK(io_read(handle, (uintptr_t)out, size, &bytes_read) ==
+		      IO_SUCCESS);
+		CHECK(io_close(handle) == IO_SUCCESS);
+		read_ns += host_time_ns() - t;
+
+		t = host_time_ns();
+		sha256_init(&hash);
+		CHECK(decode_hashed(block, block_size, size, &hash) == 0);
+		sha256_final(&hash, digest);
+		inline_ns += host_time_ns() - t;
+
+		t = host_time_ns();
+		sha256_init(&hash);
+		CHECK(decode(block, block_size, size) == 0);
+		sha256_update(&hash, out, size);
+		sha256_final(&hash, digest);
+		after_ns += host_time_ns() - t;
+	}
+
+	printf("  %zu byte image compressed to %zu bytes: "
+	       "decoded at %llu MB/s, read at %llu MB/s\n", size, block_size,
+	       (unsigned long long)(size * 1000ULL * THROUGHPUT_ROUNDS /
+				    decode_ns),
+	       (unsigned long long)(size * 1000ULL * THROUGHPUT_ROUNDS /
+				    read_ns));
+	printf("  decoded and hashed at %llu MB/s, "
+	       "decoded then hashed at %llu MB/s\n",
+	       (unsigned long long)(size * 1000ULL * THROUGHPUT_ROUNDS /
+				    inline_ns),
+	       (unsigned long long)(size * 1000ULL * THROUGHPUT_ROUNDS /
+				    after_ns));
+}
+
+int main(void)
+{
+	static const size_t sizes[] = {
+		0, 1, 4, 12, 13, 15, 16, 100, 270, 1023, 1024, 1025, 4096,
+		65536, 65537, 200000, MAX_IMAGE_SIZE
+	};
+	const struct io_dev_connector *memmap_dev_con;
+	unsigned int kind, i;
+
+	CHECK(register_io_dev_memmap(&memmap_dev_con) == IO_SUCCESS);
+	CHECK(io_dev_open(memmap_dev_con, 0, &memmap_dev_handle) ==
+	      IO_SUCCESS);
+
+	/* A block made by the reference implementation */
+	memset(out, GUARD_BYTE, sizeof(kat_plain) - 1 + GUARD_SIZE);
+	CHECK(decode(kat_block, sizeof(kat_block), sizeof(kat_plain) - 1) ==
+	      0);
+	CHECK(memcmp(out, kat_plain, sizeof(kat_plain) - 1) == 0);
+	CHECK(guard_intact(sizeof(kat_plain) - 1));
+
+	for (kind = 0; kind < 4; kind++)
+		for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+			check_round_trip(kind, sizes[i], i + 1);
+
+	check_malformed();
+	measure_throughput();
+
+	return host_test_result("test_lz4");
+}
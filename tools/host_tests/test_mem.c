@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks the firmware's memset(), memcmp(), memcpy() and memmove() against
+ * byte-wise reference implementations, for every length up to a few words
+ * and some longer ones, at every relative alignment of source and
+ * destination, and for memmove() at every overlap. Guard bytes around the
+ * destination catch any write outside of it.
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "mem_ref.h"
+
+#define MAX_SHORT_LENGTH	80
+#define NUM_ALIGNMENTS		16
+#define GUARD_SIZE		32
+#define BUF_SIZE		(GUARD_SIZE + NUM_ALIGNMENTS + 4200 + GUARD_SIZE)
+
+static const size_t long_lengths[] = { 127, 128, 129, 255, 1000, 4096, 4099 };
+
+static unsigned char src[BUF_SIZE], dst[BUF_SIZE], ref[BUF_SIZE];
+
+
+static void fill(unsigned char *buf, unsigned int seed)
+{
+	size_t i;
+
+	for (i = 0; i < BUF_SIZE; i++)
+		buf[i] = (unsigned char)(i * 13 + seed * 71 + (i >> 7));
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+static void check_length(size_t len)
+{
+	unsigned int s, d, seed = 0;
+	unsigned char *sp, *dp, *rp;
+	int val;
+
+	for (s = 0; s < NUM_ALIGNMENTS; s++) {
+		for (d = 0; d < NUM_ALIGNMENTS; d++) {
+			sp = &src[GUARD_SIZE + s];
+			dp = &dst[GUARD_SIZE + d];
+			rp = &ref[GUARD_SIZE + d];
+
+			fill(src, ++seed);
+			fill(dst, ++seed);
+			memcpy_ref(ref, dst, BUF_SIZE);
+			CHECK(memcpy(dp, sp, len) == dp);
+			memcpy_ref(rp, sp, len);
+			CHECK(memcmp_ref(dst, ref, BUF_SIZE) == 0);
+
+			/* memcmp() of equal buffers, then of one byte off */
+			CHECK(memcmp(dp, sp, len) == 0);
+			if (len != 0) {
+				dp[len / 2] ^= 0x80;
+				CHECK(sign(memcmp(dp, sp, len)) ==
+				      sign(memcmp_ref(dp, sp, len)));
+				CHECK(sign(memcmp(sp, dp, len)) ==
+				      sign(memcmp_ref(sp, dp, len)));
+				dp[len - 1] ^= 0x01;
+				CHECK(sign(memcmp(dp, sp, len)) ==
+				      sign(memcmp_ref(dp, sp, len)));
+			}
+		}
+
+		/* memset() with fill values that have the top bit set or not */
+		for (val = 0; val < 0x200; val += 0x5b) {
+			dp = &dst[GUARD_SIZE + s];
+			rp = &ref[GUARD_SIZE + s];
+
+			fill(dst, ++seed);
+			memcpy_ref(ref, dst, BUF_SIZE);
+			CHECK(memset(dp, val, len) == dp);
+			memset_ref(rp, val, len);
+			CHECK(memcmp_ref(dst, ref, BUF_SIZE) == 0);
+		}
+	}
+}
+
+/* memmove() within one buffer, with the source and destination overlapping */
+static void check_overlap(size_t len)
+{
+	unsigned int seed = 0;
+	unsigned char *sp;
+	int delta;
+
+	for (delta = -(int)len - 2; delta <= (int)len + 2; delta++) {
+		if (delta < -GUARD_SIZE - NUM_ALIGNMENTS + 1 ||
+		    delta > NUM_ALIGNMENTS + GUARD_SIZE - 1)
+			continue;
+
+		fill(dst, ++seed);
+		memcpy_ref(ref, dst, BUF_SIZE);
+
+		sp = &dst[GUARD_SIZE + NUM_ALIGNMENTS];
+		CHECK(memmove(sp + delta, sp, len) == sp + delta);
+		sp = &ref[GUARD_SIZE + NUM_ALIGNMENTS];
+		memmove_ref(sp + delta, sp, len);
+		CHECK(memcmp_ref(dst, ref, BUF_SIZE) == 0);
+	}
+}
+
+int main(void)
+{
+	size_t len, i;
+
+	for (len = 0; len <= MAX_SHORT_LENGTH; len++) {
+		check_length(len);
+		check_overlap(len);
+	}
+
+	for (i = 0; i < sizeof(long_lengths) / sizeof(long_lengths[0]); i++) {
+		check_length(long_lengths[i]);
+		check_overlap(long_lengths[i]);
+	}
+
+	return host_test_result("test_mem");
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Tests of the idle state selection of the vendor specific CPU_SUSPEND
+ * extension in services/std_svc/psci/psci_idle.c. The idle states of the
+ * platform, the PSCI state and next wake up of each cpu and the timers of the
+ * calling cpu are set up by the test, and the power_state passed to
+ * psci_cpu_suspend() is checked, in particular the demotion of a cluster power
+ * down state when another cpu in the cluster is running or will wake up too
+ * soon.
+ */
+
+#include <arch_helpers.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <string.h>
+#include "../../services/std_svc/psci/psci_private.h"
+#include "host_support.h"
+
+/* The system counter runs at 100MHz, i.e. 100 ticks per microsecond */
+#define TICKS_PER_US		100
+#define NOW			1000000
+
+/* cpu standby, cpu retention, cpu power down and cluster power down */
+#define CPU_STANDBY		0x00000000
+#define CPU_RETENTION		0x00010001
+#define CPU_POWERDOWN		0x00010000
+#define CLUSTER_POWERDOWN	0x01010000
+
+static const plat_idle_state_t idle_states[] = {
+	{ CPU_STANDBY, 1, 1, 1 },
+	{ CPU_RETENTION, 1, 1, 1 },
+	{ CPU_POWERDOWN, 40, 100, 150 },
+	{ CLUSTER_POWERDOWN, 500, 1000, 2500 },
+};
+
+/* Large enough for any state of the table */
+#define ANY_LATENCY		10000
+
+static cpu_data_t host_cpu_data[PLATFORM_CORE_COUNT];
+static aff_map_node_t cpu_nodes[PLATFORM_CORE_COUNT];
+static aff_map_node_t cluster_nodes[PLATFORM_CLUSTER_COUNT];
+
+static unsigned int suspend_calls, suspend_power_state;
+
+/*******************************************************************************
+ * The rest of BL3-1 as seen by psci_idle.c
+ ******************************************************************************/
+static unsigned int get_idle_states(const plat_idle_state_t **states)
+{
+	*states = idle_states;
+	return sizeof(idle_states) / sizeof(idle_states[0]);
+}
+
+static plat_pm_ops_t pm_ops = {
+	.get_idle_states = get_idle_states,
+};
+
+const plat_pm_ops_t *psci_plat_pm_ops = &pm_ops;
+
+cpu_data_t *_cpu_data_by_index(uint32_t cpu_index)
+{
+	return &host_cpu_data[cpu_index];
+}
+
+uint64_t plat_get_syscnt_freq(void)
+{
+	return TICKS_PER_US * 1000000ULL;
+}
+
+unsigned short psci_get_state(aff_map_node_t *node)
+{
+	return (node->state >> PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+}
+
+int psci_cpu_suspend(unsigned int power_state,
+		     unsigned long entrypoint,
+		     unsigned long context_id)
+{
+	suspend_calls++;
+	suspend_power_state = power_state;
+	return PSCI_E_SUCCESS;
+}
+
+/******************************************************************************/
+
+static void set_cpu_state(unsigned int cpu, unsigned int state,
+			  uint64_t next_wakeup)
+{
+	cpu_nodes[cpu].state = PSCI_AFF_PRESENT | (state << PSCI_STATE_SHIFT);
+	host_cpu_data[cpu].psci_svc_cpu_data.next_wakeup = next_wakeup;
+}
+
+/* Every cpu is off and the timers of the calling cpu 0 are disabled */
+static void reset(void)
+{
+	unsigned int cpu, cluster;
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		cluster = cpu / PLATFORM_MAX_CPUS_PER_CLUSTER;
+		host_cpu_data[cpu].psci_svc_cpu_data.aff_map_nodes[MPIDR_AFFLVL0] =
+			&cpu_nodes[cpu];
+		host_cpu_data[cpu].psci_svc_cpu_data.aff_map_nodes[MPIDR_AFFLVL1] =
+			&cluster_nodes[cluster];
+		set_cpu_state(cpu, PSCI_STATE_OFF, 0);
+	}
+	set_cpu_state(0, PSCI_STATE_ON, 0);
+
+	host_cntpct_el0 = NOW;
+	host_cntp_ctl_el0 = 0;
+	host_cntv_ctl_el0 = 0;
+	host_cntvoff_el2 = 0;
+	host_id_aa64pfr0_el1 = 0;
+}
+
+/* Return the power_state entered for 'latency', or -1 for a plain wfi */
+static int suspend(unsigned int latency)
+{
+	suspend_calls = 0;
+	CHECK(psci_cpu_suspend_latency(latency, 0, 0) == PSCI_E_SUCCESS);
+	CHECK(suspend_calls <= 1);
+
+	return suspend_calls ? (int)suspend_power_state : -1;
+}
+
+static void test_latency(void)
+{
+	reset();
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+	CHECK(suspend(1500) == CLUSTER_POWERDOWN);
+	CHECK(suspend(1499) == CPU_POWERDOWN);
+	CHECK(suspend(140) == CPU_POWERDOWN);
+	CHECK(suspend(139) == CPU_RETENTION);
+	CHECK(suspend(1) == -1);
+}
+
+static void test_siblings(void)
+{
+	uint64_t cluster_deadline = NOW + 2500 * TICKS_PER_US;
+
+	/* Any cpu of the other cluster does not matter */
+	reset();
+	set_cpu_state(PLATFORM_MAX_CPUS_PER_CLUSTER, PSCI_STATE_ON, 0);
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+
+	/* A running sibling demotes the cluster power down */
+	reset();
+	set_cpu_state(1, PSCI_STATE_ON, 0);
+	CHECK(suspend(ANY_LATENCY) == CPU_POWERDOWN);
+
+	reset();
+	set_cpu_state(2, PSCI_STATE_ON_PENDING, 0);
+	CHECK(suspend(ANY_LATENCY) == CPU_POWERDOWN);
+
+	/* So does a suspended sibling which wakes up within the residency */
+	reset();
+	set_cpu_state(1, PSCI_STATE_SUSPEND, cluster_deadline - 1);
+	CHECK(suspend(ANY_LATENCY) == CPU_POWERDOWN);
+
+	reset();
+	set_cpu_state(1, PSCI_STATE_SUSPEND, cluster_deadline);
+	set_cpu_state(3, PSCI_STATE_SUSPEND, UINT64_MAX);
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+}
+
+static void test_timers(void)
+{
+	/* The physical timer only counts when enabled and unmasked */
+	reset();
+	host_cntp_cval_el0 = NOW + 200 * TICKS_PER_US;
+	host_cntp_ctl_el0 = 1 << CNTP_CTL_ENABLE_SHIFT;
+	CHECK(suspend(ANY_LATENCY) == CPU_POWERDOWN);
+	host_cntp_cval_el0 = NOW + 100 * TICKS_PER_US;
+	CHECK(suspend(ANY_LATENCY) == CPU_RETENTION);
+	host_cntp_ctl_el0 |= 1 << CNTP_CTL_IMASK_SHIFT;
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+
+	/* Without EL2, the virtual timer compares against the system counter */
+	reset();
+	host_cntv_cval_el0 = NOW + 200 * TICKS_PER_US;
+	host_cntv_ctl_el0 = 1 << CNTP_CTL_ENABLE_SHIFT;
+	host_cntvoff_el2 = 1000 * TICKS_PER_US;
+	CHECK(suspend(ANY_LATENCY) == CPU_POWERDOWN);
+	host_cntv_ctl_el0 = 0;
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+
+	/* With EL2, it is offset by CNTVOFF_EL2 */
+	host_id_aa64pfr0_el1 = 1 << ID_AA64PFR0_EL2_SHIFT;
+	host_cntv_ctl_el0 = 1 << CNTP_CTL_ENABLE_SHIFT;
+	host_cntv_cval_el0 = NOW - 900 * TICKS_PER_US;
+	CHECK(suspend(ANY_LATENCY) == CPU_RETENTION);
+	host_cntv_cval_el0 = NOW + 2000 * TICKS_PER_US;
+	CHECK(suspend(ANY_LATENCY) == CLUSTER_POWERDOWN);
+}
+
+static void test_record_next_wakeup(void)
+{
+	reset();
+	host_cntp_cval_el0 = NOW + 300;
+	host_cntp_ctl_el0 = 1 << CNTP_CTL_ENABLE_SHIFT;
+	host_cntv_cval_el0 = 200;
+	host_cntv_ctl_el0 = 1 << CNTP_CTL_ENABLE_SHIFT;
+	host_id_aa64pfr0_el1 = 1 << ID_AA64PFR0_EL2_SHIFT;
+	host_cntvoff_el2 = NOW;
+	psci_idle_record_next_wakeup();
+	CHECK(host_cpu_data[0].psci_svc_cpu_data.next_wakeup == NOW + 200);
+
+	host_cntp_ctl_el0 = 0;
+	host_cntv_ctl_el0 = 0;
+	psci_idle_record_next_wakeup();
+	CHECK(host_cpu_data[0].psci_svc_cpu_data.next_wakeup == UINT64_MAX);
+}
+
+int main(void)
+{
+	host_set_cpu(0);
+	write_tpidr_el3((uint64_t)&host_cpu_data[0]);
+
+	test_latency();
+	test_siblings();
+	test_timers();
+	test_record_next_wakeup();
+
+	/* The platform does not have to describe its idle states */
+	pm_ops.get_idle_states = NULL;
+	CHECK(psci_cpu_suspend_latency(ANY_LATENCY, 0, 0) ==
+	      PSCI_E_NOT_SUPPORTED);
+
+	return host_test_result("test_psci_idle");
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Simulation of CPU_ON racing with CPU_OFF when the state of the PSCI cpus is
+ * managed without locks. The firmware's PSCI sources are built with
+ * PSCI_LOCKLESS_CPU_STATE=1 and every cpu of the platform is a host thread.
+ * Each cpu other than cpu 0 runs the normal world for a while and turns
+ * itself off through psci_afflvl_off(), which also powers its cluster off when
+ * it is the last one running in it. It then waits for the platform to power
+ * it up again and goes through the warm boot path. Meanwhile, cpu 0 keeps
+ * turning on cpus picked at random, many of which are still powering down.
+ *
+ * Every lock acquisition first gives the other cpus a chance to run, which
+ * widens the windows between the steps of a power down. A CPU_ON which waits
+ * for its target while holding locks the target needs deadlocks, which the
+ * watchdog reports as a failure. The platform hooks check that a cpu is only
+ * powered up once it has left coherency, that a cluster is only powered down
+ * while no other cpu in it is coherent, and that it is powered up whenever one
+ * of its cpus runs the normal world.
+ */
+
+#include <arch_helpers.h>
+#include <bakery_lock.h>
+#include <bl_common.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../services/std_svc/psci/psci_private.h"
+#include "host_support.h"
+
+#define ITERATIONS	500
+#define WATCHDOG_SECS	30
+
+extern const afflvl_power_on_finisher_t psci_afflvl_on_finishers[];
+
+static cpu_data_t host_cpu_data[PLATFORM_CORE_COUNT];
+
+/* State of the simulated platform */
+static volatile int cluster_up[PLATFORM_CLUSTER_COUNT];
+static volatile int cpu_in_ns[PLATFORM_CORE_COUNT];
+static volatile int cpu_coherent[PLATFORM_CORE_COUNT];
+static volatile int cpu_power_on[PLATFORM_CORE_COUNT];
+static volatile int cpus_done;
+
+static unsigned int cluster_offs, on_while_pwrdn;
+
+#define cluster_of(mpidr)	(((mpidr) >> MPIDR_AFF1_SHIFT) & \
+				 MPIDR_AFFLVL_MASK)
+
+/*******************************************************************************
+ * Platform power management hooks
+ ******************************************************************************/
+static int sim_affinst_on(unsigned long mpidr, unsigned long sec_entrypoint,
+			  unsigned long ns_entrypoint, unsigned int afflvl,
+			  unsigned int state)
+{
+	unsigned int cpu = platform_get_core_pos(mpidr);
+
+	if (afflvl != MPIDR_AFFLVL0)
+		return PSCI_E_SUCCESS;
+
+	/* The cpu must have completed its power down operations */
+	CHECK(!cpu_in_ns[cpu]);
+	CHECK(!cpu_coherent[cpu]);
+	CHECK(!cpu_power_on[cpu]);
+	cpu_power_on[cpu] = 1;
+	return PSCI_E_SUCCESS;
+}
+
+static int sim_affinst_off(unsigned long mpidr, unsigned int afflvl,
+			   unsigned int state)
+{
+	unsigned int cluster = cluster_of(mpidr), cpu;
+
+	if (afflvl != MPIDR_AFFLVL1 || state != PSCI_STATE_OFF)
+		return PSCI_E_SUCCESS;
+
+	/* No other cpu of the cluster may still be in the coherency domain */
+	for (cpu = cluster * PLATFORM_MAX_CPUS_PER_CLUSTER;
+	     cpu < (cluster + 1) * PLATFORM_MAX_CPUS_PER_CLUSTER; cpu++) {
+		CHECK(!cpu_in_ns[cpu]);
+		if (cpu != platform_get_core_pos(mpidr))
+			CHECK(!cpu_coherent[cpu]);
+	}
+
+	CHECK(cluster_up[cluster]);
+	cluster_up[cluster] = 0;
+	__sync_fetch_and_add(&cluster_offs, 1);
+	return PSCI_E_SUCCESS;
+}
+
+static int sim_affinst_on_finish(unsigned long mpidr, unsigned int afflvl,
+				 unsigned int state)
+{
+	unsigned int cluster = cluster_of(mpidr);
+
+	if (afflvl != MPIDR_AFFLVL1 || state != PSCI_STATE_OFF)
+		return PSCI_E_SUCCESS;
+
+	CHECK(!cluster_up[cluster]);
+	cluster_up[cluster] = 1;
+	return PSCI_E_SUCCESS;
+}
+
+static const plat_pm_ops_t sim_pm_ops = {
+	.affinst_on = sim_affinst_on,
+	.affinst_off = sim_affinst_off,
+	.affinst_on_finish = sim_affinst_on_finish,
+};
+
+int platform_setup_pm(const plat_pm_ops_t **plat_ops)
+{
+	*plat_ops = &sim_pm_ops;
+	return 0;
+}
+
+int plat_get_max_afflvl(void)
+{
+	return MPIDR_AFFLVL1;
+}
+
+unsigned int plat_get_aff_count(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return aff_lvl == MPIDR_AFFLVL1 ? PLATFORM_CLUSTER_COUNT :
+		aff_lvl == MPIDR_AFFLVL0 ? PLATFORM_MAX_CPUS_PER_CLUSTER : 1;
+}
+
+unsigned int plat_get_aff_state(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return PSCI_AFF_PRESENT;
+}
+
+uint64_t plat_get_syscnt_freq(void)
+{
+	return 100000000;
+}
+
+/*******************************************************************************
+ * The rest of BL3-1 as seen by PSCI
+ ******************************************************************************/
+cpu_data_t *_cpu_data_by_index(uint32_t cpu_index)
+{
+	return &host_cpu_data[cpu_index];
+}
+
+cpu_data_t *_cpu_data_by_mpidr(uint64_t mpidr)
+{
+	return &host_cpu_data[platform_get_core_pos(mpidr)];
+}
+
+void cm_init_context(uint64_t mpidr, const entry_point_info_t *ep)
+{
+}
+
+void cm_prepare_el3_exit(uint32_t security_state)
+{
+}
+
+void cm_set_context_by_mpidr(uint64_t mpidr, void *context,
+			     uint32_t security_state)
+{
+}
+
+void bl31_arch_setup(void)
+{
+}
+
+void psci_aff_on_finish_entry(void)
+{
+}
+
+void psci_aff_suspend_finish_entry(void)
+{
+}
+
+void psci_idle_record_next_wakeup(void)
+{
+}
+
+/* A cpu leaves coherency when it flushes its caches to power down */
+void psci_do_pwrdown_cache_maintenance(uint32_t affinity_level)
+{
+	cpu_coherent[platform_get_core_pos(read_mpidr_el1())] = 0;
+	sched_yield();
+}
+
+void psci_do_pwrup_cache_maintenance(void)
+{
+	cpu_coherent[platform_get_core_pos(read_mpidr_el1())] = 1;
+}
+
+/* Let the other cpus run before each lock acquisition (see the Makefile) */
+void __real_bakery_lock_get(bakery_lock_t *bakery);
+
+void __wrap_bakery_lock_get(bakery_lock_t *bakery)
+{
+	sched_yield();
+	__real_bakery_lock_get(bakery);
+}
+
+/******************************************************************************/
+
+static void watchdog(int sig)
+{
+	static const char msg[] = "test_psci_lockless: FAILED (deadlock)\n";
+
+	write(STDERR_FILENO, msg, sizeof(msg) - 1);
+	_exit(1);
+}
+
+/* Run the normal world for a short random time */
+static void run_ns(unsigned int cpu, unsigned int *seed)
+{
+	unsigned long mpidr = host_cpu_mpidr(cpu);
+	unsigned int i, n = rand_r(seed) % 4;
+
+	cpu_in_ns[cpu] = 1;
+	for (i = 0; i <= n; i++) {
+		CHECK(cluster_up[cluster_of(mpidr)]);
+		CHECK(psci_get_state(psci_get_aff_map_node(mpidr,
+				MPIDR_AFFLVL0)) == PSCI_STATE_ON);
+		sched_yield();
+	}
+	cpu_in_ns[cpu] = 0;
+}
+
+/* Go through the warm boot path once the platform powers this cpu up */
+static void warm_boot(unsigned int cpu)
+{
+	while (!cpu_power_on[cpu])
+		sched_yield();
+
+	psci_afflvl_power_on_finish(MPIDR_AFFLVL0,
+				    get_power_on_target_afflvl(),
+				    (afflvl_power_on_finisher_t *)
+				    psci_afflvl_on_finishers);
+}
+
+static void *cpu_main(void *arg)
+{
+	unsigned int cpu = (uintptr_t)arg;
+	unsigned int seed = cpu, i;
+
+	host_set_cpu(cpu);
+	write_tpidr_el3((uint64_t)&host_cpu_data[cpu]);
+
+	for (i = 0; i < ITERATIONS; i++) {
+		warm_boot(cpu);
+		run_ns(cpu, &seed);
+
+		/* Turn this cpu off, as psci_cpu_off() does */
+		CHECK(psci_afflvl_off(MPIDR_AFFLVL0, MPIDR_AFFLVL1) ==
+		      PSCI_E_SUCCESS);
+		cpu_power_on[cpu] = 0;
+	}
+
+	warm_boot(cpu);
+	__sync_fetch_and_add(&cpus_done, 1);
+
+	return NULL;
+}
+
+/* Turn on cpus at random from cpu 0 until all of them are done */
+static void turn_on_cpus(void)
+{
+	unsigned int seed = 0, cpu;
+	aff_map_node_t *node;
+	int pwrdn, rc;
+
+	while (cpus_done < PLATFORM_CORE_COUNT - 1) {
+		cpu = 1 + rand_r(&seed) % (PLATFORM_CORE_COUNT - 1);
+		node = psci_get_aff_map_node(host_cpu_mpidr(cpu),
+					     MPIDR_AFFLVL0);
+		pwrdn = *(volatile unsigned char *)&node->state &
+			PSCI_AFF_PWRDN_PENDING;
+
+		rc = psci_afflvl_on(host_cpu_mpidr(cpu), 0, 0, MPIDR_AFFLVL0,
+				    MPIDR_AFFLVL1);
+		CHECK(rc == PSCI_E_SUCCESS || rc == PSCI_E_ALREADY_ON ||
+		      rc == PSCI_E_ON_PENDING);
+		if (pwrdn && rc == PSCI_E_SUCCESS)
+			on_while_pwrdn++;
+
+		run_ns(0, &seed);
+	}
+}
+
+int main(void)
+{
+	pthread_t threads[PLATFORM_CORE_COUNT];
+	aff_map_node_t *node;
+	unsigned int cpu, cluster;
+
+	signal(SIGALRM, watchdog);
+	alarm(WATCHDOG_SECS);
+
+	/* Cold boot on cpu 0, which then turns on all the others */
+	host_set_cpu(0);
+	write_tpidr_el3((uint64_t)&host_cpu_data[0]);
+	CHECK(psci_setup() == 0);
+	cluster_up[0] = 1;
+	cpu_coherent[0] = 1;
+
+	for (cpu = 1; cpu < PLATFORM_CORE_COUNT; cpu++)
+		CHECK(pthread_create(&threads[cpu], NULL, cpu_main,
+				     (void *)(uintptr_t)cpu) == 0);
+
+	turn_on_cpus();
+
+	for (cpu = 1; cpu < PLATFORM_CORE_COUNT; cpu++)
+		pthread_join(threads[cpu], NULL);
+	alarm(0);
+
+	/* Everything is on again and no transition is left pending */
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		node = psci_get_aff_map_node(host_cpu_mpidr(cpu),
+					     MPIDR_AFFLVL0);
+		CHECK(psci_get_state(node) == PSCI_STATE_ON);
+		CHECK(!(node->state & PSCI_AFF_FLAGS));
+	}
+
+	for (cluster = 0; cluster < PLATFORM_CLUSTER_COUNT; cluster++) {
+		node = psci_get_aff_map_node(cluster << MPIDR_AFF1_SHIFT,
+					     MPIDR_AFFLVL1);
+		CHECK(node->ref_count == PLATFORM_MAX_CPUS_PER_CLUSTER);
+		CHECK(node->in_transition == 0);
+		CHECK(cluster_up[cluster]);
+	}
+
+	/* CPU_ON must have been called on cpus which were powering down */
+	CHECK(cluster_offs && on_while_pwrdn);
+	printf("  %u cluster power downs, %u cpus turned on while powering "
+	       "down\n", cluster_offs, on_while_pwrdn);
+
+	return host_test_result("test_psci_lockless");
+}
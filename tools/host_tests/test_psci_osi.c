@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Simulation of the PSCI state machine in OS-initiated mode. The firmware's
+ * PSCI sources are built with PSCI_OS_INIT_MODE=1 and every cpu of the
+ * platform is a host thread. Each cpu runs the normal world for a while,
+ * then asks to be suspended through psci_afflvl_suspend(). Like an OS in
+ * OS-initiated mode, the last cpu running in a cluster asks for the cluster
+ * to be suspended as well. A suspended cpu later wakes up through the warm
+ * boot path, psci_afflvl_power_on_finish(), and goes back to the normal
+ * world.
+ *
+ * The view of the OS is deliberately racy: a cpu coming out of suspend only
+ * counts itself as running once it is back in the normal world, so the last
+ * cpu often asks for its cluster to be suspended while another cpu is on its
+ * way up. The platform hooks check that a cluster is only powered down while
+ * every other cpu in it has left coherency and none runs the normal world,
+ * and each cpu checks that its cluster is powered up whenever it runs the
+ * normal world.
+ */
+
+#include <arch_helpers.h>
+#include <bl_common.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include "../../services/std_svc/psci/psci_private.h"
+#include "host_support.h"
+
+#define ITERATIONS	2000
+
+extern const afflvl_power_on_finisher_t psci_afflvl_on_finishers[];
+extern const afflvl_power_on_finisher_t psci_afflvl_suspend_finishers[];
+
+static cpu_data_t host_cpu_data[PLATFORM_CORE_COUNT];
+
+/* State of the simulated platform and of the simulated OS */
+static volatile int cluster_up[PLATFORM_CLUSTER_COUNT];
+static volatile int cpu_in_ns[PLATFORM_CORE_COUNT];
+static volatile int cpu_coherent[PLATFORM_CORE_COUNT];
+static unsigned int os_running[PLATFORM_CLUSTER_COUNT];
+
+static unsigned int cluster_suspended, cluster_denied;
+
+#define cluster_of(mpidr)	(((mpidr) >> MPIDR_AFF1_SHIFT) & \
+				 MPIDR_AFFLVL_MASK)
+
+/*******************************************************************************
+ * Platform power management hooks
+ ******************************************************************************/
+static int sim_affinst_on(unsigned long mpidr, unsigned long sec_entrypoint,
+			  unsigned long ns_entrypoint, unsigned int afflvl,
+			  unsigned int state)
+{
+	return PSCI_E_SUCCESS;
+}
+
+static int sim_affinst_suspend(unsigned long mpidr,
+			       unsigned long sec_entrypoint,
+			       unsigned long ns_entrypoint,
+			       unsigned int afflvl,
+			       unsigned int state)
+{
+	unsigned int cluster = cluster_of(mpidr), cpu;
+
+	if (afflvl != MPIDR_AFFLVL1 || state != PSCI_STATE_OFF)
+		return PSCI_E_SUCCESS;
+
+	/*
+	 * No other cpu of the cluster may still run the normal world or have
+	 * its data cache in the coherency domain
+	 */
+	for (cpu = cluster * PLATFORM_MAX_CPUS_PER_CLUSTER;
+	     cpu < (cluster + 1) * PLATFORM_MAX_CPUS_PER_CLUSTER; cpu++) {
+		CHECK(!cpu_in_ns[cpu]);
+		if (cpu != platform_get_core_pos(mpidr))
+			CHECK(!cpu_coherent[cpu]);
+	}
+
+	CHECK(cluster_up[cluster]);
+	cluster_up[cluster] = 0;
+	__sync_fetch_and_add(&cluster_suspended, 1);
+	return PSCI_E_SUCCESS;
+}
+
+static int sim_affinst_finish(unsigned long mpidr, unsigned int afflvl,
+			      unsigned int state)
+{
+	unsigned int cluster = cluster_of(mpidr);
+
+	if (afflvl != MPIDR_AFFLVL1 || state != PSCI_STATE_OFF)
+		return PSCI_E_SUCCESS;
+
+	CHECK(!cluster_up[cluster]);
+	cluster_up[cluster] = 1;
+	return PSCI_E_SUCCESS;
+}
+
+static const plat_pm_ops_t sim_pm_ops = {
+	.affinst_on = sim_affinst_on,
+	.affinst_suspend = sim_affinst_suspend,
+	.affinst_on_finish = sim_affinst_finish,
+	.affinst_suspend_finish = sim_affinst_finish,
+};
+
+int platform_setup_pm(const plat_pm_ops_t **plat_ops)
+{
+	*plat_ops = &sim_pm_ops;
+	return 0;
+}
+
+int plat_get_max_afflvl(void)
+{
+	return MPIDR_AFFLVL1;
+}
+
+unsigned int plat_get_aff_count(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return aff_lvl == MPIDR_AFFLVL1 ? PLATFORM_CLUSTER_COUNT :
+		aff_lvl == MPIDR_AFFLVL0 ? PLATFORM_MAX_CPUS_PER_CLUSTER : 1;
+}
+
+unsigned int plat_get_aff_state(unsigned int aff_lvl, unsigned long mpidr)
+{
+	return PSCI_AFF_PRESENT;
+}
+
+uint64_t plat_get_syscnt_freq(void)
+{
+	return 100000000;
+}
+
+/*******************************************************************************
+ * The rest of BL3-1 as seen by PSCI. The calls made while a cpu powers itself
+ * down or up give the other cpus a chance to run, so that they can observe
+ * the intermediate states.
+ ******************************************************************************/
+cpu_data_t *_cpu_data_by_index(uint32_t cpu_index)
+{
+	return &host_cpu_data[cpu_index];
+}
+
+cpu_data_t *_cpu_data_by_mpidr(uint64_t mpidr)
+{
+	return &host_cpu_data[platform_get_core_pos(mpidr)];
+}
+
+void cm_init_context(uint64_t mpidr, const entry_point_info_t *ep)
+{
+	sched_yield();
+}
+
+void cm_prepare_el3_exit(uint32_t security_state)
+{
+	sched_yield();
+}
+
+void cm_set_context_by_mpidr(uint64_t mpidr, void *context,
+			     uint32_t security_state)
+{
+}
+
+void bl31_arch_setup(void)
+{
+}
+
+void psci_aff_on_finish_entry(void)
+{
+}
+
+void psci_aff_suspend_finish_entry(void)
+{
+}
+
+/* A cpu leaves coherency when it flushes its caches to power down */
+void psci_do_pwrdown_cache_maintenance(uint32_t affinity_level)
+{
+	cpu_coherent[platform_get_core_pos(read_mpidr_el1())] = 0;
+}
+
+void psci_do_pwrup_cache_maintenance(void)
+{
+	cpu_coherent[platform_get_core_pos(read_mpidr_el1())] = 1;
+}
+
+void psci_idle_record_next_wakeup(void)
+{
+	sched_yield();
+}
+
+/******************************************************************************/
+
+/* Run the normal world for a short random time */
+static void run_ns(unsigned int cpu, unsigned int *seed)
+{
+	unsigned long mpidr = host_cpu_mpidr(cpu);
+	unsigned int i, n = rand_r(seed) % 4;
+
+	cpu_in_ns[cpu] = 1;
+	for (i = 0; i <= n; i++) {
+		CHECK(cluster_up[cluster_of(mpidr)]);
+		CHECK(psci_get_state(psci_get_aff_map_node(mpidr,
+				MPIDR_AFFLVL0)) == PSCI_STATE_ON);
+		sched_yield();
+	}
+	cpu_in_ns[cpu] = 0;
+}
+
+/* Go through the warm boot path, as psci_entry.S does */
+static void warm_boot(const afflvl_power_on_finisher_t *finishers)
+{
+	psci_afflvl_power_on_finish(MPIDR_AFFLVL0,
+				    get_power_on_target_afflvl(),
+				    (afflvl_power_on_finisher_t *)finishers);
+}
+
+static void *cpu_main(void *arg)
+{
+	unsigned int cpu = (uintptr_t)arg;
+	unsigned int cluster = cpu / PLATFORM_MAX_CPUS_PER_CLUSTER;
+	unsigned int seed = cpu, afflvl, power_state, i, n;
+	int rc;
+
+	host_set_cpu(cpu);
+	write_tpidr_el3((uint64_t)&host_cpu_data[cpu]);
+
+	if (cpu != 0)
+		warm_boot(psci_afflvl_on_finishers);
+	__sync_fetch_and_add(&os_running[cluster], 1);
+
+	for (i = 0; i < ITERATIONS; i++) {
+		run_ns(cpu, &seed);
+
+		/* The last cpu running in the cluster suspends it too */
+		afflvl = __sync_sub_and_fetch(&os_running[cluster], 1) ?
+			MPIDR_AFFLVL0 : MPIDR_AFFLVL1;
+		power_state = (PSTATE_TYPE_POWERDOWN << PSTATE_TYPE_SHIFT) |
+			(afflvl << PSTATE_AFF_LVL_SHIFT);
+
+		rc = psci_afflvl_suspend(0, 0, power_state, MPIDR_AFFLVL0,
+					 afflvl);
+		if (rc == PSCI_E_SUCCESS) {
+			/* Stay powered down for a while, then wake up */
+			for (n = rand_r(&seed) % 8; n; n--)
+				sched_yield();
+			warm_boot(psci_afflvl_suspend_finishers);
+
+			/* The OS takes a while to count this cpu back in */
+			sched_yield();
+		} else {
+			CHECK(rc == PSCI_E_DENIED && afflvl == MPIDR_AFFLVL1);
+			__sync_fetch_and_add(&cluster_denied, 1);
+		}
+
+		__sync_fetch_and_add(&os_running[cluster], 1);
+	}
+
+	return NULL;
+}
+
+int main(void)
+{
+	pthread_t threads[PLATFORM_CORE_COUNT];
+	aff_map_node_t *node;
+	unsigned int cpu, cluster;
+
+	/* Cold boot on cpu 0, which then turns on all the others */
+	host_set_cpu(0);
+	write_tpidr_el3((uint64_t)&host_cpu_data[0]);
+	CHECK(psci_setup() == 0);
+	cluster_up[0] = 1;
+	cpu_coherent[0] = 1;
+
+	for (cpu = 1; cpu < PLATFORM_CORE_COUNT; cpu++)
+		CHECK(psci_afflvl_on(host_cpu_mpidr(cpu), 0, 0, MPIDR_AFFLVL0,
+				     MPIDR_AFFLVL1) == PSCI_E_SUCCESS);
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		CHECK(pthread_create(&threads[cpu], NULL, cpu_main,
+				     (void *)(uintptr_t)cpu) == 0);
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		pthread_join(threads[cpu], NULL);
+
+	/* Everything is on again and no transition is left pending */
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		node = psci_get_aff_map_node(host_cpu_mpidr(cpu),
+					     MPIDR_AFFLVL0);
+		CHECK(psci_get_state(node) == PSCI_STATE_ON);
+		CHECK(!(node->state & PSCI_AFF_FLAGS));
+	}
+
+	for (cluster = 0; cluster < PLATFORM_CLUSTER_COUNT; cluster++) {
+		node = psci_get_aff_map_node(cluster << MPIDR_AFF1_SHIFT,
+					     MPIDR_AFFLVL1);
+		CHECK(psci_get_state(node) == PSCI_STATE_ON);
+		CHECK(node->ref_count == PLATFORM_MAX_CPUS_PER_CLUSTER);
+		CHECK(!(node->state & PSCI_AFF_OSI_OFF));
+		CHECK(cluster_up[cluster]);
+	}
+
+	/* Both outcomes of a cluster suspend must have been exercised */
+	CHECK(cluster_suspended && cluster_denied);
+	printf("  %u cluster suspends, %u denied\n", cluster_suspended,
+	       cluster_denied);
+
+	return host_test_result("test_psci_osi");
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Checks the SHA-256 code used by measured boot against the FIPS 180-2 test
+ * vectors and against digests of messages of every length up to several
+ * blocks, each hashed in one go and in random pieces. Reports the hashing
+ * throughput. When built for an AArch64 host whose cpu implements the SHA-256
+ * instructions, the Cryptographic Extension path is checked and measured in
+ * the same way, and compared with the C path on random messages.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <sha256.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_support.h"
+#if SHA256_CRYPTO_EXT
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#define NUM_LENGTHS		300
+#define NUM_RANDOM		2000
+#define MAX_RANDOM_LENGTH	1000
+#define THROUGHPUT_SIZE		(1024 * 1024)
+#define THROUGHPUT_ROUNDS	64
+
+static const struct {
+	const char *message;
+	const char *digest;
+} vectors[] = {
+	{ "",
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abc",
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+	  "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+	  "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+};
+
+static const char million_a_digest[] =
+	"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+/*
+ * SHA-256 of the concatenated digests of the messages of every length below
+ * NUM_LENGTHS whose byte i is (i * 7 + length) & 0xff, computed with another
+ * implementation
+ */
+static const char lengths_digest[] =
+	"d5238871a46ac4a1a75ac3fb19d645b0b3b9e5f35f5f720e2b240d605c6b694e";
+
+static uint8_t buf[THROUGHPUT_SIZE];
+
+
+static int digest_is(const uint8_t digest[SHA256_DIGEST_SIZE],
+		     const char *hex)
+{
+	char str[2 * SHA256_DIGEST_SIZE + 1];
+	unsigned int i;
+
+	for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+		sprintf(&str[2 * i], "%02x", digest[i]);
+
+	return strcmp(str, hex) == 0;
+}
+
+static void hash(const void *data, size_t length,
+		 uint8_t digest[SHA256_DIGEST_SIZE])
+{
+	sha256_ctx_t ctx;
+
+	sha256_init(&ctx);
+	sha256_update(&ctx, data, length);
+	sha256_final(&ctx, digest);
+}
+
+/* Hash a message in pieces of random lengths, including empty ones */
+static void hash_in_pieces(const uint8_t *data, size_t length,
+			   uint8_t digest[SHA256_DIGEST_SIZE],
+			   unsigned int *seed)
+{
+	sha256_ctx_t ctx;
+	size_t n;
+
+	sha256_init(&ctx);
+	while (length != 0) {
+		n = rand_r(seed) % 150;
+		if (n > length)
+			n = length;
+		sha256_update(&ctx, data, n);
+		data += n;
+		length -= n;
+	}
+	sha256_final(&ctx, digest);
+}
+
+static void check_vectors(void)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	sha256_ctx_t ctx, lengths_ctx;
+	unsigned int i, seed = 1;
+	size_t length, n;
+
+	for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		hash(vectors[i].message, strlen(vectors[i].message), digest);
+		CHECK(digest_is(digest, vectors[i].digest));
+	}
+
+	/* A million 'a', in pieces of odd lengths */
+	memset(buf, 'a', 1000000);
+	sha256_init(&ctx);
+	for (length = 0, n = 1; length < 1000000; length += n) {
+		n = n * 7 % 1013 + 1;
+		if (n > 1000000 - length)
+			n = 1000000 - length;
+		sha256_update(&ctx, &buf[length], n);
+	}
+	sha256_final(&ctx, digest);
+	CHECK(digest_is(digest, million_a_digest));
+
+	/* Messages ending on each side of the block and padding boundaries */
+	sha256_init(&lengths_ctx);
+	for (length = 0; length < NUM_LENGTHS; length++) {
+		uint8_t pieces_digest[SHA256_DIGEST_SIZE];
+
+		for (i = 0; i < length; i++)
+			buf[i] = i * 7 + length;
+		hash(buf, length, digest);
+		hash_in_pieces(buf, length, pieces_digest, &seed);
+		CHECK(memcmp(digest, pieces_digest, sizeof(digest)) == 0);
+		sha256_update(&lengths_ctx, digest, sizeof(digest));
+	}
+	sha256_final(&lengths_ctx, digest);
+	CHECK(digest_is(digest, lengths_digest));
+}
+
+/* Report the hashing speed of the selected path */
+static void measure_throughput(const char *path)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	unsigned int i;
+	uint64_t t;
+
+	memset(buf, 0x5a, sizeof(buf));
+	t = host_time_ns();
+	for (i = 0; i < THROUGHPUT_ROUNDS; i++)
+		hash(buf, sizeof(buf), digest);
+	t = host_time_ns() - t;
+
+	printf("  %s: %llu MB/s\n", path,
+	       (unsigned long long)(sizeof(buf) * 1000ULL *
+				    THROUGHPUT_ROUNDS / t));
+}
+
+#if SHA256_CRYPTO_EXT
+/* Check that both paths agree on random messages at random alignments */
+static void compare_paths(uint64_t ce_isar0)
+{
+	uint8_t c_digest[SHA256_DIGEST_SIZE], ce_digest[SHA256_DIGEST_SIZE];
+	unsigned int seed = 2, i;
+	size_t length, offset, j;
+
+	for (i = 0; i < NUM_RANDOM; i++) {
+		length = rand_r(&seed) % MAX_RANDOM_LENGTH;
+		offset = rand_r(&seed) % 16;
+		for (j = 0; j < length; j++)
+			buf[offset + j] = rand_r(&seed);
+
+		host_id_aa64isar0_el1 = 0;
+		hash(&buf[offset], length, c_digest);
+		host_id_aa64isar0_el1 = ce_isar0;
+		hash(&buf[offset], length, ce_digest);
+		CHECK(memcmp(c_digest, ce_digest, sizeof(c_digest)) == 0);
+	}
+}
+#endif
+
+int main(void)
+{
+#if SHA256_CRYPTO_EXT
+	uint64_t ce_isar0 = 1ULL << ID_AA64ISAR0_SHA2_SHIFT;
+#endif
+
+	/* The C path is used when the cpu lacks the SHA-256 instructions */
+	host_id_aa64isar0_el1 = 0;
+	check_vectors();
+	measure_throughput("C");
+
+#if SHA256_CRYPTO_EXT
+	if (getauxval(AT_HWCAP) & HWCAP_SHA2) {
+		host_id_aa64isar0_el1 = ce_isar0;
+		check_vectors();
+		measure_throughput("Cryptographic Extension");
+		compare_paths(ce_isar0);
+	} else {
+		printf("  Cryptographic Extension: not implemented by this "
+		       "cpu, not checked\n");
+	}
+#else
+	printf("  Cryptographic Extension: not built for this host, "
+	       "not checked\n");
+#endif
+
+	return host_test_result("test_sha256");
+}